@@ -0,0 +1,250 @@
+#include "AotCompiler.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <spdlog/fmt/fmt.h>
+#include "../Chip8/Chip8.h"
+#include "../Disassembler/Disassembler.h"
+
+enum class OpKind {
+    // Compiled into the block; execution continues with the next opcode
+    Straight,
+    // Compiled and ends the block (1NNN, 2NNN, 00EE)
+    Terminator,
+    // Left to the interpreter; ends the block before it
+    Interpreted,
+    // Not a valid opcode, so probably data. Nothing past it is followed
+    Invalid,
+};
+
+static OpKind Classify(uint16_t opcode) {
+    switch ((opcode & 0xF000u) >> 12) {
+        case 0x0:
+            if (opcode == 0x00E0)
+                return OpKind::Straight;
+            if (opcode == 0x00EE)
+                return OpKind::Terminator;
+            return OpKind::Invalid;
+        case 0x1:
+        case 0x2:
+            return OpKind::Terminator;
+        case 0x6:
+        case 0x7:
+        case 0xA:
+        case 0xC:
+            return OpKind::Straight;
+        case 0x8:
+            switch (opcode & 0x000Fu) {
+                case 0x0: case 0x1: case 0x2: case 0x3: case 0x4:
+                case 0x5: case 0x6: case 0x7: case 0xE:
+                    return OpKind::Straight;
+                default:
+                    return OpKind::Invalid;
+            }
+        case 0x3:
+        case 0x4:
+        case 0x5:
+        case 0x9:
+        case 0xB:
+        case 0xD:
+        case 0xE:
+            return OpKind::Interpreted;
+        case 0xF:
+            switch (opcode & 0x00FFu) {
+                case 0x07: case 0x15: case 0x18: case 0x1E: case 0x29: case 0x65:
+                    return OpKind::Straight;
+                case 0x0A: case 0x33: case 0x55:
+                    return OpKind::Interpreted;
+                default:
+                    return OpKind::Invalid;
+            }
+        default:
+            return OpKind::Invalid;
+    }
+}
+
+// 3XNN, 4XNN, 5XY0, 9XY0, EX9E and EXA1, the only opcodes that can continue at address + 4
+static bool IsSkip(uint16_t opcode) {
+    switch ((opcode & 0xF000u) >> 12) {
+        case 0x3:
+        case 0x4:
+        case 0x5:
+        case 0x9:
+            return true;
+        case 0xE:
+            return (opcode & 0x00FFu) == 0x9E || (opcode & 0x00FFu) == 0xA1;
+        default:
+            return false;
+    }
+}
+
+std::vector<CompiledBlock> RecoverBlocks(const uint8_t *rom, size_t size) {
+    uint8_t memory[4096]{};
+    memcpy(&memory[START_ADDRESS], rom, std::min(size, (size_t) MAX_ROM_SIZE));
+
+    std::vector<CompiledBlock> blocks;
+    std::bitset<4096> visited;
+    std::vector<uint16_t> worklist{START_ADDRESS};
+
+    while (!worklist.empty()) {
+        uint16_t entry = worklist.back();
+        worklist.pop_back();
+        if (entry + 1u >= sizeof(memory) || visited[entry])
+            continue;
+        visited.set(entry);
+
+        CompiledBlock block{entry, {}, false};
+        uint16_t address = entry;
+        while (address + 1u < sizeof(memory)) {
+            uint16_t opcode = (memory[address] << 8) | memory[address + 1];
+            OpKind kind = Classify(opcode);
+
+            if (kind == OpKind::Straight) {
+                block.opcodes.push_back(opcode);
+                address += 2;
+                continue;
+            }
+            if (kind == OpKind::Terminator) {
+                block.opcodes.push_back(opcode);
+                if ((opcode & 0xF000u) != 0x0000u)
+                    worklist.push_back(opcode & 0x0FFFu);
+                // The call returns to the next instruction
+                if ((opcode & 0xF000u) == 0x2000u)
+                    worklist.push_back(address + 2);
+                break;
+            }
+            if (kind == OpKind::Interpreted) {
+                block.fallsThrough = true;
+                // The interpreter runs this opcode and hands back at whichever successor it lands on.
+                // BNNN's target depends on V0, so it has none we can know
+                if ((opcode & 0xF000u) != 0xB000u)
+                    worklist.push_back(address + 2);
+                if (IsSkip(opcode))
+                    worklist.push_back(address + 4);
+                break;
+            }
+            // Invalid: stop following this path
+            block.fallsThrough = true;
+            break;
+        }
+
+        if (!block.opcodes.empty())
+            blocks.push_back(std::move(block));
+    }
+
+    std::sort(blocks.begin(), blocks.end(),
+              [](const CompiledBlock &a, const CompiledBlock &b) { return a.address < b.address; });
+    return blocks;
+}
+
+// Statements equivalent to Chip8::Execute for a compilable opcode, operating on `c`
+static std::string EmitOpcode(uint16_t opcode, uint16_t address) {
+    unsigned int x = (opcode & 0x0F00u) >> 8;
+    unsigned int y = (opcode & 0x00F0u) >> 4;
+    unsigned int nn = opcode & 0x00FFu;
+    unsigned int nnn = opcode & 0x0FFFu;
+    std::string vx = fmt::format("c.registers[0x{:X}]", x);
+    std::string vy = fmt::format("c.registers[0x{:X}]", y);
+    const std::string vf = "c.registers[0xF]";
+
+    switch ((opcode & 0xF000u) >> 12) {
+        case 0x0:
+            if (opcode == 0x00E0)
+                return "memset(c.display, 0, sizeof(c.display));";
+            return "c.pc = c.stack[c.sp--];\n    return;";
+        case 0x1:
+            return fmt::format("c.pc = 0x{:03X};\n    return;", nnn);
+        case 0x2:
+            return fmt::format("c.stack[++c.sp] = 0x{:03X};\n    c.pc = 0x{:03X};\n    return;", address + 2, nnn);
+        case 0x6:
+            return fmt::format("{} = 0x{:02X};", vx, nn);
+        case 0x7:
+            return fmt::format("{} += 0x{:02X};", vx, nn);
+        case 0x8:
+            // Flag and result ordering follows the interpreter, which matters when X or Y is F
+            switch (opcode & 0x000Fu) {
+                case 0x0:
+                    return fmt::format("{} = {};", vx, vy);
+                case 0x1:
+                    return fmt::format("{} |= {};", vx, vy);
+                case 0x2:
+                    return fmt::format("{} &= {};", vx, vy);
+                case 0x3:
+                    return fmt::format("{} ^= {};", vx, vy);
+                case 0x4:
+                    return fmt::format("{2} = {0} + {1} > 255;\n    {0} += {1};", vx, vy, vf);
+                case 0x5:
+                    return fmt::format("{2} = {0} > {1};\n    {0} -= {1};", vx, vy, vf);
+                case 0x6:
+                    return fmt::format("{1} = {0} & 0x01u;\n    {0} >>= 1;", vx, vf);
+                case 0x7:
+                    return fmt::format("{2} = {1} > {0};\n    {0} = {1} - {0};", vx, vy, vf);
+                default:
+                    return fmt::format("{1} = ({0} & 0x80u) >> 7;\n    {0} <<= 1;", vx, vf);
+            }
+        case 0xA:
+            return fmt::format("c.index = 0x{:03X};", nnn);
+        case 0xC:
+            return fmt::format("{} = c.random(c.rng) & 0x{:02X};", vx, nn);
+        default:
+            switch (opcode & 0x00FFu) {
+                case 0x07:
+                    return fmt::format("{} = c.delayTimer;", vx);
+                case 0x15:
+                    return fmt::format("c.delayTimer = {};", vx);
+                case 0x18:
+                    return fmt::format("c.soundTimer = {};", vx);
+                case 0x1E:
+                    return fmt::format("c.index += {};", vx);
+                case 0x29:
+                    return fmt::format("c.index = (5 * {}) + 0x{:03X};", vx, FONT_START_ADDRESS);
+                default: {
+                    std::string out;
+                    for (unsigned int i = 0; i <= x; ++i) {
+                        out += fmt::format("{}c.registers[0x{:X}] = c.memory[c.index + {}];", i ? "\n    " : "", i, i);
+                    }
+                    return out;
+                }
+            }
+    }
+}
+
+std::string EmitSource(const std::vector<CompiledBlock> &blocks, uint64_t romHash) {
+    std::string out = fmt::format("// Generated by chip8-aot for ROM {:016X}. Do not edit.\n"
+                                  "#include <cstring>\n"
+                                  "#include \"Aot/AotModule.h\"\n"
+                                  "#include \"Chip8/Chip8.h\"\n\n", romHash);
+
+    for (const auto &block : blocks) {
+        out += fmt::format("static const uint16_t Opcodes_{:03X}[] = {{", block.address);
+        for (size_t i = 0; i < block.opcodes.size(); ++i) {
+            out += fmt::format("{}0x{:04X}", i ? ", " : "", block.opcodes[i]);
+        }
+        out += "};\n\n";
+
+        out += fmt::format("static void Block_{:03X}(Chip8 &c) {{\n", block.address);
+        uint16_t address = block.address;
+        for (uint16_t opcode : block.opcodes) {
+            out += fmt::format("    // 0x{:03X}  {}\n", address, Disassemble(opcode));
+            out += "    " + EmitOpcode(opcode, address) + "\n";
+            address += 2;
+        }
+        if (block.fallsThrough)
+            out += fmt::format("    c.pc = 0x{:03X};\n", address);
+        out += "}\n\n";
+    }
+
+    out += "static const AotBlockInfo BLOCKS[] = {\n";
+    for (const auto &block : blocks) {
+        out += fmt::format("        {{0x{0:03X}, {1}, Block_{0:03X}, Opcodes_{0:03X}}},\n",
+                           block.address, block.opcodes.size());
+    }
+    out += "};\n\n";
+
+    out += fmt::format("static const AotManifest MANIFEST = {{AOT_ABI_VERSION, sizeof(Chip8), 0x{:016X}ull, {}, BLOCKS}};\n\n",
+                       romHash, blocks.size());
+    out += "extern \"C\" const AotManifest *chip8_aot_manifest() {\n"
+           "    return &MANIFEST;\n"
+           "}\n";
+    return out;
+}
@@ -0,0 +1,25 @@
+#ifndef CHIP8_AOTCOMPILER_H
+#define CHIP8_AOTCOMPILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A straight-line run of compilable opcodes, entered only at its first address
+struct CompiledBlock {
+    uint16_t address;
+    std::vector<uint16_t> opcodes;
+    // Set when the block ends before an interpreted opcode rather than on a jump, call or return
+    bool fallsThrough;
+};
+
+// Walks the control-flow graph from START_ADDRESS and returns a block for every reachable entry point.
+// Skips, DXYN, BNNN, FX0A and the memory-writing FX33 / FX55 are left to the interpreter
+std::vector<CompiledBlock> RecoverBlocks(const uint8_t *rom, size_t size);
+
+// C++ source for a shared object exporting the blocks through the AotModule ABI
+std::string EmitSource(const std::vector<CompiledBlock> &blocks, uint64_t romHash);
+
+
+#endif //CHIP8_AOTCOMPILER_H
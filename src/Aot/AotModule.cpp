@@ -0,0 +1,79 @@
+#include "AotModule.h"
+#include <dlfcn.h>
+#include <stdexcept>
+#include "../Logger/Logger.h"
+#include "../Timing/Timing.h"
+
+AotModule::AotModule(const std::string &path, uint64_t romHash, const TimingModel &model) {
+    handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        std::string error = dlerror();
+        ERROR("dlopen: " + error);
+        throw std::runtime_error(error);
+    }
+
+    auto manifestFn = reinterpret_cast<AotManifestFn>(dlsym(handle, AOT_MANIFEST_SYMBOL));
+    const AotManifest *manifest = manifestFn ? manifestFn() : nullptr;
+    std::string problem;
+    if (!manifest)
+        problem = "no manifest";
+    else if (manifest->abiVersion != AOT_ABI_VERSION || manifest->chip8Size != sizeof(Chip8))
+        problem = "built against a different emulator version";
+    else if (manifest->romHash != romHash)
+        problem = "compiled from a different ROM";
+    if (!problem.empty()) {
+        dlclose(handle);
+        ERROR("AOT module " + path + ": " + problem);
+        throw std::runtime_error(problem);
+    }
+
+    // Every compiled opcode has a state-independent cost, so each block's cost is fixed for the model
+    Chip8 idle;
+    blocks.reserve(manifest->blockCount);
+    for (uint32_t i = 0; i < manifest->blockCount; ++i) {
+        const AotBlockInfo &info = manifest->blocks[i];
+        Block block{info.run, info.count, 0};
+        bool usable = true;
+        for (unsigned int op = 0; op < info.count; ++op) {
+            block.cost += model.Cost(idle, info.opcodes[op]);
+            usable = usable && !model.WaitsForDisplay(info.opcodes[op]);
+            code.set((info.address + 2 * op) & 0x0FFFu);
+            code.set((info.address + 2 * op + 1) & 0x0FFFu);
+        }
+        if (usable)
+            blocks.push_back(block);
+        else
+            blocks.push_back({nullptr, 0, 0});
+    }
+    for (uint32_t i = 0; i < manifest->blockCount; ++i) {
+        if (blocks[i].run)
+            table[manifest->blocks[i].address & 0x0FFFu] = &blocks[i];
+    }
+    INFO("Loaded " + std::to_string(manifest->blockCount) + " compiled blocks from " + path);
+}
+
+AotModule::~AotModule() {
+    dlclose(handle);
+}
+
+void AotModule::CheckWrite(const Chip8 &chip8, uint16_t opcode) {
+    // Already abandoned; nothing left to protect
+    if (!valid)
+        return;
+
+    // Compiled blocks never write memory, so FX33 and FX55 in the interpreter are the only way to modify code
+    unsigned int length = 0;
+    if ((opcode & 0xF0FFu) == 0xF033u)
+        length = 3;
+    else if ((opcode & 0xF0FFu) == 0xF055u)
+        length = ((opcode & 0x0F00u) >> 8) + 1;
+
+    for (unsigned int i = 0; i < length; ++i) {
+        if (code[(chip8.index + i) & 0x0FFFu]) {
+            WARN(fmt::format("ROM wrote to compiled code at 0x{:03X}, falling back to the interpreter",
+                             chip8.index + i));
+            valid = false;
+            return;
+        }
+    }
+}
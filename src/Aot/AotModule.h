@@ -0,0 +1,76 @@
+#ifndef CHIP8_AOTMODULE_H
+#define CHIP8_AOTMODULE_H
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Chip8/Chip8.h"
+
+// ABI between chip8-aot generated shared objects and the runtime. Bump the version on any change
+const uint32_t AOT_ABI_VERSION = 1;
+
+// Runs a compiled block and leaves pc at the next instruction. Blocks never write to memory
+using AotBlockFn = void (*)(Chip8 &chip8);
+
+struct AotBlockInfo {
+    uint16_t address;
+    uint16_t count;
+    AotBlockFn run;
+    const uint16_t *opcodes;
+};
+
+struct AotManifest {
+    uint32_t abiVersion;
+    uint32_t chip8Size;
+    uint64_t romHash;
+    uint32_t blockCount;
+    const AotBlockInfo *blocks;
+};
+
+// Exported with C linkage by every generated shared object
+using AotManifestFn = const AotManifest *(*)();
+
+const char *const AOT_MANIFEST_SYMBOL = "chip8_aot_manifest";
+
+class TimingModel;
+
+// A dlopen'ed chip8-aot module, with block costs bound to a timing model
+class AotModule {
+public:
+    struct Block {
+        AotBlockFn run;
+        unsigned int count;
+        unsigned int cost;
+    };
+
+    // Throws if the module can't be loaded or wasn't compiled from this ROM
+    AotModule(const std::string &path, uint64_t romHash, const TimingModel &model);
+
+    AotModule(const AotModule &) = delete;
+
+    AotModule &operator=(const AotModule &) = delete;
+
+    ~AotModule();
+
+    bool Valid() const { return valid; }
+
+    // The compiled block starting at address, if there is one
+    const Block *Lookup(uint16_t address) const {
+        return valid ? table[address & 0x0FFFu] : nullptr;
+    }
+
+    // Abandons the module if an interpreted opcode is about to write over compiled code
+    void CheckWrite(const Chip8 &chip8, uint16_t opcode);
+
+private:
+    void *handle;
+    bool valid{true};
+    std::vector<Block> blocks;
+    const Block *table[4096]{};
+    // Every byte some compiled block was generated from
+    std::bitset<4096> code;
+};
+
+
+#endif //CHIP8_AOTMODULE_H
@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <fstream>
+#include "AotCompiler.h"
+#include "../Logger/Logger.h"
+#include "../Rom/Rom.h"
+
+// Set by CMake; both can be overridden on the command line
+#ifndef CHIP8_SOURCE_DIR
+#define CHIP8_SOURCE_DIR "src"
+#endif
+#ifndef CHIP8_AOT_CXX
+#define CHIP8_AOT_CXX "c++"
+#endif
+
+int main(int argc, char **argv) {
+    Logger::Init();
+
+    std::string cxx = CHIP8_AOT_CXX;
+    std::string include = CHIP8_SOURCE_DIR;
+    std::string sourcePath;
+    std::string romPath;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--cxx" && i + 1 < argc) {
+            cxx = argv[++i];
+        } else if (arg == "--include" && i + 1 < argc) {
+            include = argv[++i];
+        } else if (arg == "--source" && i + 1 < argc) {
+            sourcePath = argv[++i];
+        } else if (romPath.empty()) {
+            romPath = arg;
+        } else {
+            outputPath = arg;
+        }
+    }
+
+    if (romPath.empty() || outputPath.empty()) {
+        ERROR("Usage: chip8-aot [--cxx COMPILER] [--include CHIP8_SRC_DIR] [--source PATH] ROM OUTPUT.so");
+        exit(1);
+    }
+
+    std::shared_ptr<const RomImage> rom;
+    try {
+        rom = RomCache::Global().Load(romPath);
+    } catch (std::exception &e) {
+        ERROR(e.what());
+        exit(1);
+    }
+
+    auto blocks = RecoverBlocks(rom->Data(), rom->Size());
+    size_t opcodes = 0;
+    for (const auto &block : blocks)
+        opcodes += block.opcodes.size();
+    INFO("Recovered " + std::to_string(blocks.size()) + " blocks covering " + std::to_string(opcodes) + " opcodes");
+
+    // Keep the generated source next to the output unless told otherwise, it's handy when debugging a module
+    if (sourcePath.empty())
+        sourcePath = outputPath + ".cpp";
+    {
+        std::ofstream source(sourcePath, std::ios::trunc);
+        if (!source) {
+            ERROR("Failed to write " + sourcePath);
+            exit(1);
+        }
+        source << EmitSource(blocks, rom->Hash());
+    }
+
+    std::string command = cxx + " -std=c++17 -O2 -shared -fPIC -I'" + include + "' '" + sourcePath + "' -o '" +
+                          outputPath + "'";
+    INFO(command);
+    if (std::system(command.c_str()) != 0) {
+        ERROR("Compiling " + sourcePath + " failed");
+        exit(1);
+    }
+    INFO("Wrote " + outputPath);
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "Audio.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include "../Logger/Logger.h"
+#include "../Timing/Timing.h"
+
+const unsigned int SAMPLE_RATE = 44100;
+// 512 samples is ~11.6 ms of buffering at 44.1 kHz
+const uint16_t BUFFER_SAMPLES = 512;
+const unsigned int TONE_HZ = 440;
+const int32_t TONE_AMPLITUDE = 6000;
+const unsigned int RAMP_SAMPLES = 64;
+
+ToneSynth::ToneSynth(unsigned int sampleRate)
+    : phaseStep{(uint32_t) (((uint64_t) TONE_HZ << 32) / sampleRate)},
+      rampStep{TONE_AMPLITUDE / (int32_t) RAMP_SAMPLES} {}
+
+void ToneSynth::Render(bool on, int16_t *samples, size_t count) {
+    int32_t target = on ? TONE_AMPLITUDE : 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (amplitude < target)
+            amplitude = std::min(amplitude + rampStep, target);
+        else if (amplitude > target)
+            amplitude = std::max(amplitude - rampStep, target);
+
+        samples[i] = (int16_t) (phase < 0x80000000u ? amplitude : -amplitude);
+        // Keep the oscillator running while silent so the phase stays continuous
+        phase += phaseStep;
+    }
+}
+
+void NullAudio::Publish(bool toneOn) {}
+
+SdlAudio::SdlAudio() : synth{SAMPLE_RATE} {
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+        ERROR("SDL_InitSubSystem: ", SDL_GetError());
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    SDL_AudioSpec want{};
+    want.freq = SAMPLE_RATE;
+    want.format = AUDIO_S16SYS;
+    want.channels = 1;
+    want.samples = BUFFER_SAMPLES;
+    want.callback = Callback;
+    want.userdata = this;
+
+    // No allowed changes: SDL converts for us, so the callback always sees this exact format
+    device = SDL_OpenAudioDevice(nullptr, 0, &want, nullptr, 0);
+    if (device == 0) {
+        ERROR("SDL_OpenAudioDevice: ", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        throw std::runtime_error(SDL_GetError());
+    }
+    SDL_PauseAudioDevice(device, 0);
+}
+
+SdlAudio::~SdlAudio() {
+    SDL_CloseAudioDevice(device);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+void SdlAudio::Publish(bool toneOn) {
+    tone.store(toneOn, std::memory_order_release);
+}
+
+void SdlAudio::Callback(void *userdata, Uint8 *stream, int length) {
+    auto *audio = static_cast<SdlAudio *>(userdata);
+    bool on = audio->tone.load(std::memory_order_acquire);
+    audio->synth.Render(on, reinterpret_cast<int16_t *>(stream), length / sizeof(int16_t));
+}
+
+static void WriteLittleEndian(std::ofstream &file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        file.put((char) ((value >> (8 * i)) & 0xFFu));
+    }
+}
+
+static void WriteWavHeader(std::ofstream &file, uint32_t samples) {
+    uint32_t dataBytes = samples * sizeof(int16_t);
+    file.write("RIFF", 4);
+    WriteLittleEndian(file, 36 + dataBytes, 4);
+    file.write("WAVEfmt ", 8);
+    WriteLittleEndian(file, 16, 4);
+    WriteLittleEndian(file, 1, 2); // PCM
+    WriteLittleEndian(file, 1, 2); // mono
+    WriteLittleEndian(file, SAMPLE_RATE, 4);
+    WriteLittleEndian(file, SAMPLE_RATE * sizeof(int16_t), 4);
+    WriteLittleEndian(file, sizeof(int16_t), 2);
+    WriteLittleEndian(file, 16, 2);
+    file.write("data", 4);
+    WriteLittleEndian(file, dataBytes, 4);
+}
+
+WavAudio::WavAudio(const std::string &path) : file{path, std::ios::binary | std::ios::trunc}, synth{SAMPLE_RATE} {
+    if (!file) {
+        ERROR("Failed to open WAV file: " + path);
+        throw std::ios::failure(strerror(errno));
+    }
+    // Sizes are unknown until the run ends, so the header is rewritten on close
+    WriteWavHeader(file, 0);
+}
+
+WavAudio::~WavAudio() {
+    file.seekp(0);
+    WriteWavHeader(file, samplesWritten);
+}
+
+void WavAudio::Publish(bool toneOn) {
+    int16_t samples[SAMPLE_RATE / FRAMES_PER_SECOND];
+    synth.Render(toneOn, samples, sizeof(samples) / sizeof(samples[0]));
+    for (int16_t sample : samples) {
+        WriteLittleEndian(file, (uint16_t) sample, 2);
+    }
+    samplesWritten += sizeof(samples) / sizeof(samples[0]);
+}
@@ -0,0 +1,74 @@
+#ifndef CHIP8_AUDIO_H
+#define CHIP8_AUDIO_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Square wave generator. Not thread safe; each output owns one
+class ToneSynth {
+public:
+    explicit ToneSynth(unsigned int sampleRate);
+
+    // Renders mono samples, ramping the amplitude briefly on changes to avoid clicks
+    void Render(bool on, int16_t *samples, size_t count);
+
+private:
+    uint32_t phase{};
+    uint32_t phaseStep;
+    int32_t amplitude{};
+    int32_t rampStep;
+};
+
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    // Called once per 60 Hz frame with whether the sound timer is running
+    virtual void Publish(bool toneOn) = 0;
+};
+
+class NullAudio : public AudioSink {
+public:
+    void Publish(bool toneOn) override;
+};
+
+// Plays through SDL. The callback reads a single atomic, so it never locks or allocates
+class SdlAudio : public AudioSink {
+public:
+    SdlAudio();
+
+    ~SdlAudio() override;
+
+    void Publish(bool toneOn) override;
+
+private:
+    static void Callback(void *userdata, Uint8 *stream, int length);
+
+    std::atomic<bool> tone{false};
+    static_assert(std::atomic<bool>::is_always_lock_free, "audio callback needs a lock-free tone state");
+
+    // Only touched from the audio callback once the device is running
+    ToneSynth synth;
+    SDL_AudioDeviceID device{};
+};
+
+// Renders one frame of samples per Publish into a WAV file, for headless runs
+class WavAudio : public AudioSink {
+public:
+    explicit WavAudio(const std::string &path);
+
+    ~WavAudio() override;
+
+    void Publish(bool toneOn) override;
+
+private:
+    std::ofstream file;
+    ToneSynth synth;
+    uint32_t samplesWritten{};
+};
+
+
+#endif //CHIP8_AUDIO_H
@@ -1,11 +1,11 @@
 #include "Chip8.h"
-#include <fstream>
+#include <cstring>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 #include "../Logger/Logger.h"
+#include "../Rom/Rom.h"
 
-const unsigned int START_ADDRESS = 0x200;
-const unsigned int FONT_START_ADDRESS = 0x050;
 const unsigned int FONTSET_SIZE = 80;
 const uint8_t FONTSET[FONTSET_SIZE] = {
         0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
@@ -27,40 +27,36 @@ const uint8_t FONTSET[FONTSET_SIZE] = {
 };
 
 void Chip8::LoadROM(const std::string &path) {
-    // Load ROM file
-    std::ifstream rom(path, std::ios::binary | std::ios::ate);
-    if (rom.fail() || !rom.is_open()) {
-        ERROR("Failed to open ROM: " + path);
-        throw std::ios::failure(std::strerror(errno));
+    LoadROM(*RomCache::Global().Load(path));
+}
+
+void Chip8::LoadROM(const RomImage &rom) {
+    if (rom.Size() > MAX_ROM_SIZE) {
+        ERROR("ROM of " + std::to_string(rom.Size()) + " bytes doesn't fit in memory");
+        throw std::length_error("ROM too large");
     }
 
     // Place into memory at START_ADDRESS
-    std::streampos size = rom.tellg();
-    char *buffer = new char[size];
-    rom.seekg(0, std::ios::beg);
-    rom.read(buffer, size);
-    rom.close();
-
-    for (size_t i = 0; i <= size; ++i) {
-        memory[START_ADDRESS + i] = buffer[i];
-    }
+    memcpy(&memory[START_ADDRESS], rom.Data(), rom.Size());
 }
 
 uint16_t Chip8::Fetch() {
     // Read instruction from PC
     uint16_t opcode = (memory[pc] << 8) | memory[pc + 1];
-    DEBUG("Opcode: " + fmt::format("{:X}", opcode));
 
     // Increment PC
     pc += 2;
 
+    return opcode;
+}
+
+void Chip8::TickTimers() {
+    // Both timers count down at 60 Hz, independently of instruction speed
     if (soundTimer > 0)
         soundTimer--;
 
     if (delayTimer > 0)
         delayTimer--;
-
-    return opcode;
 }
 
 void Chip8::Execute(uint16_t opcode) {
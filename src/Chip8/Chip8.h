@@ -6,16 +6,27 @@
 #include <vector>
 #include <random>
 
+class RomImage;
+
+const unsigned int START_ADDRESS = 0x200;
+const unsigned int FONT_START_ADDRESS = 0x050;
+const size_t MAX_ROM_SIZE = 4096 - START_ADDRESS;
+
 struct Chip8 {
 
     Chip8();
 
+    // Loads through the global ROM cache
     void LoadROM(const std::string &path);
 
+    void LoadROM(const RomImage &rom);
+
     uint16_t Fetch();
 
     void Execute(uint16_t);
 
+    void TickTimers();
+
     uint8_t memory[4096]{};
     uint8_t registers[16]{};
     uint16_t index{};
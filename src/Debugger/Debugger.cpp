@@ -0,0 +1,297 @@
+#include "Debugger.h"
+#include <iostream>
+#include <sstream>
+#include "../Disassembler/Disassembler.h"
+#include "../Logger/Logger.h"
+
+const char *const HELP =
+        "c                 continue\n"
+        "s [N]             step N instructions (default 1)\n"
+        "n                 step over CALL\n"
+        "f                 run until the current subroutine returns\n"
+        "b [ADDR]          set a breakpoint, or list them\n"
+        "d ADDR            delete a breakpoint\n"
+        "w ADDR [LEN]      watch memory writes\n"
+        "uw ADDR [LEN]     stop watching memory\n"
+        "wi                toggle watching I\n"
+        "cond VX OP NN     break when the condition becomes true (OP: == != < > <= >=)\n"
+        "cond clear        remove all conditions\n"
+        "r                 show registers\n"
+        "x ADDR [LEN]      dump memory\n"
+        "dis [ADDR] [N]    disassemble N instructions (default PC, 10)\n"
+        "q                 quit\n"
+        "Numbers are hex.\n";
+
+volatile std::sig_atomic_t Debugger::interrupted = 0;
+
+void Debugger::OnInterrupt(int) {
+    // Only flag it; the scheduler notices on its next frame
+    Debugger::interrupted = 1;
+}
+
+static bool ParseHex(const std::string &token, unsigned long &value) {
+    try {
+        size_t used;
+        value = std::stoul(token, &used, 16);
+        return used == token.size();
+    } catch (std::exception &) {
+        return false;
+    }
+}
+
+Debugger::Debugger(bool breakOnStart) {
+    if (breakOnStart) {
+        pendingBreak = true;
+        breakReason = "Stopped at entry";
+    }
+    std::signal(SIGINT, OnInterrupt);
+}
+
+bool Debugger::BeforeExecute(Chip8 &chip8) {
+    if (interrupted) {
+        interrupted = 0;
+        pendingBreak = true;
+        breakReason = "Interrupted";
+    }
+    if (armedBreakpoints && breakpoints[chip8.pc & 0x0FFFu] && !pendingBreak) {
+        pendingBreak = true;
+        breakReason = fmt::format("Breakpoint at 0x{:03X}", chip8.pc);
+    }
+    if (pendingBreak) {
+        pendingBreak = false;
+        Repl(chip8);
+        if (quitRequested)
+            return false;
+    }
+
+    indexBefore = chip8.index;
+    writesWatched = false;
+    if (armedWatchpoints) {
+        // Only FX33 and FX55 write to memory, so the written range is known before executing
+        uint16_t opcode = (chip8.memory[chip8.pc & 0x0FFFu] << 8) | chip8.memory[(chip8.pc + 1) & 0x0FFFu];
+        unsigned int length = 0;
+        if ((opcode & 0xF0FFu) == 0xF033u)
+            length = 3;
+        else if ((opcode & 0xF0FFu) == 0xF055u)
+            length = ((opcode & 0x0F00u) >> 8) + 1;
+        for (unsigned int i = 0; i < length; ++i) {
+            if (watchedMemory[(chip8.index + i) & 0x0FFFu])
+                writesWatched = true;
+        }
+    }
+    return true;
+}
+
+void Debugger::AfterExecute(Chip8 &chip8) {
+    if (watchIndex && chip8.index != indexBefore) {
+        pendingBreak = true;
+        breakReason = fmt::format("I changed 0x{:03X} -> 0x{:03X}", indexBefore, chip8.index);
+    }
+    if (writesWatched) {
+        pendingBreak = true;
+        breakReason = fmt::format("Watched memory written from I = 0x{:03X}", chip8.index);
+    }
+    for (auto &condition : conditions) {
+        // Break on the transition only, or we'd stop on every instruction while it holds
+        bool result = Evaluate(condition, chip8);
+        if (result && !condition.lastResult) {
+            pendingBreak = true;
+            breakReason = fmt::format("Condition V{:X} {} 0x{:02X} met", condition.reg, condition.op, condition.value);
+        }
+        condition.lastResult = result;
+    }
+
+    switch (mode) {
+        case Mode::Run:
+            break;
+        case Mode::Step:
+            if (--stepsLeft == 0) {
+                mode = Mode::Run;
+                pendingBreak = true;
+                breakReason = "Step";
+            }
+            break;
+        case Mode::StepOver:
+            if (chip8.pc == stepOverTarget && chip8.sp == stepDepth) {
+                mode = Mode::Run;
+                pendingBreak = true;
+                breakReason = "Step over";
+            }
+            break;
+        case Mode::StepOut:
+            if (chip8.sp < stepDepth) {
+                mode = Mode::Run;
+                pendingBreak = true;
+                breakReason = "Returned";
+            }
+            break;
+    }
+}
+
+bool Debugger::Evaluate(const Condition &condition, const Chip8 &chip8) {
+    uint8_t value = chip8.registers[condition.reg];
+    if (condition.op == "==")
+        return value == condition.value;
+    if (condition.op == "!=")
+        return value != condition.value;
+    if (condition.op == "<")
+        return value < condition.value;
+    if (condition.op == ">")
+        return value > condition.value;
+    if (condition.op == "<=")
+        return value <= condition.value;
+    return value >= condition.value;
+}
+
+void Debugger::Repl(Chip8 &chip8) {
+    std::cout << breakReason << "\n";
+    PrintDisassembly(chip8, chip8.pc, 1);
+
+    std::string line;
+    while (std::cout << "(chip8) " << std::flush, std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command, arg1, arg2, arg3;
+        in >> command >> arg1 >> arg2 >> arg3;
+        unsigned long a = 0, b = 0;
+
+        if (command.empty()) {
+            continue;
+        } else if (command == "c") {
+            return;
+        } else if (command == "s") {
+            stepsLeft = arg1.empty() || !ParseHex(arg1, a) || a == 0 ? 1 : a;
+            mode = Mode::Step;
+            return;
+        } else if (command == "n") {
+            uint16_t opcode = (chip8.memory[chip8.pc & 0x0FFFu] << 8) | chip8.memory[(chip8.pc + 1) & 0x0FFFu];
+            if ((opcode & 0xF000u) == 0x2000u) {
+                mode = Mode::StepOver;
+                stepOverTarget = chip8.pc + 2;
+                stepDepth = chip8.sp;
+            } else {
+                mode = Mode::Step;
+                stepsLeft = 1;
+            }
+            return;
+        } else if (command == "f") {
+            if (chip8.sp == 0) {
+                std::cout << "Not in a subroutine\n";
+                continue;
+            }
+            mode = Mode::StepOut;
+            stepDepth = chip8.sp;
+            return;
+        } else if (command == "b") {
+            if (arg1.empty()) {
+                for (size_t i = 0; i < breakpoints.size(); ++i) {
+                    if (breakpoints[i])
+                        std::cout << fmt::format("  0x{:03X}  {}\n", i,
+                                                 Disassemble((chip8.memory[i] << 8) | chip8.memory[(i + 1) & 0x0FFFu]));
+                }
+            } else if (ParseHex(arg1, a) && a < breakpoints.size()) {
+                if (!breakpoints[a]) {
+                    breakpoints.set(a);
+                    ++armedBreakpoints;
+                }
+            } else {
+                std::cout << "Bad address\n";
+            }
+        } else if (command == "d") {
+            if (ParseHex(arg1, a) && a < breakpoints.size() && breakpoints[a]) {
+                breakpoints.reset(a);
+                --armedBreakpoints;
+            } else {
+                std::cout << "No breakpoint there\n";
+            }
+        } else if (command == "w" || command == "uw") {
+            if (!ParseHex(arg1, a) || a >= watchedMemory.size()) {
+                std::cout << "Bad address\n";
+                continue;
+            }
+            if (arg2.empty() || !ParseHex(arg2, b) || b == 0)
+                b = 1;
+            for (unsigned long i = a; i < a + b && i < watchedMemory.size(); ++i) {
+                watchedMemory[i] = command == "w";
+            }
+            armedWatchpoints = watchedMemory.count();
+        } else if (command == "wi") {
+            watchIndex = !watchIndex;
+            std::cout << (watchIndex ? "Watching I\n" : "Not watching I\n");
+        } else if (command == "cond") {
+            if (arg1 == "clear") {
+                conditions.clear();
+                continue;
+            }
+            unsigned long reg;
+            bool validOp = arg2 == "==" || arg2 == "!=" || arg2 == "<" || arg2 == ">" || arg2 == "<=" || arg2 == ">=";
+            if (arg1.size() != 2 || (arg1[0] | 0x20) != 'v' || !ParseHex(arg1.substr(1), reg) || !validOp
+                || !ParseHex(arg3, b) || b > 0xFF) {
+                std::cout << "Usage: cond VX OP NN\n";
+                continue;
+            }
+            Condition condition{(unsigned int) reg, arg2, (uint8_t) b, false};
+            condition.lastResult = Evaluate(condition, chip8);
+            conditions.push_back(condition);
+        } else if (command == "r") {
+            PrintRegisters(chip8);
+        } else if (command == "x") {
+            if (!ParseHex(arg1, a) || a >= sizeof(chip8.memory)) {
+                std::cout << "Bad address\n";
+                continue;
+            }
+            if (arg2.empty() || !ParseHex(arg2, b) || b == 0)
+                b = 0x40;
+            PrintMemory(chip8, a, b);
+        } else if (command == "dis") {
+            if (arg1.empty()) {
+                a = chip8.pc;
+            } else if (!ParseHex(arg1, a) || a >= sizeof(chip8.memory)) {
+                std::cout << "Bad address\n";
+                continue;
+            }
+            if (arg2.empty() || !ParseHex(arg2, b) || b == 0)
+                b = 10;
+            PrintDisassembly(chip8, a, b);
+        } else if (command == "q") {
+            quitRequested = true;
+            return;
+        } else {
+            std::cout << HELP;
+        }
+    }
+
+    // Stdin closed; keep running without breaking again
+    mode = Mode::Run;
+}
+
+void Debugger::PrintRegisters(const Chip8 &chip8) const {
+    std::string out;
+    for (unsigned int i = 0; i < 16; ++i) {
+        out += fmt::format("V{:X}={:02X}{}", i, chip8.registers[i], i % 8 == 7 ? "\n" : " ");
+    }
+    out += fmt::format("PC={:03X} I={:03X} SP={:X} DT={:02X} ST={:02X}\n",
+                       chip8.pc, chip8.index, chip8.sp, chip8.delayTimer, chip8.soundTimer);
+    for (unsigned int i = 1; i <= chip8.sp && i < 16; ++i) {
+        out += fmt::format("  stack[{:X}] = {:03X}\n", i, chip8.stack[i]);
+    }
+    std::cout << out;
+}
+
+void Debugger::PrintDisassembly(const Chip8 &chip8, uint16_t address, unsigned int count) const {
+    for (unsigned int i = 0; i < count && address + 1u < sizeof(chip8.memory); ++i, address += 2) {
+        uint16_t opcode = (chip8.memory[address] << 8) | chip8.memory[address + 1];
+        std::cout << fmt::format("{}{} 0x{:03X}  {:04X}  {}\n",
+                                 address == chip8.pc ? '>' : ' ', breakpoints[address] ? '*' : ' ',
+                                 address, opcode, Disassemble(opcode));
+    }
+}
+
+void Debugger::PrintMemory(const Chip8 &chip8, uint16_t address, unsigned int length) const {
+    std::string out;
+    for (unsigned int i = 0; i < length && address + i < sizeof(chip8.memory); ++i) {
+        if (i % 16 == 0)
+            out += fmt::format("{}0x{:03X}:", i ? "\n" : "", address + i);
+        out += fmt::format(" {:02X}", chip8.memory[address + i]);
+    }
+    std::cout << out << "\n";
+}
@@ -0,0 +1,84 @@
+#ifndef CHIP8_DEBUGGER_H
+#define CHIP8_DEBUGGER_H
+
+#include <bitset>
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Chip8/Chip8.h"
+
+// Console debugger. The scheduler only runs its debug loop while Active(), so an idle debugger costs nothing
+class Debugger {
+public:
+    // Installs a SIGINT handler that breaks into the console; create before SDL so it keeps the signal
+    explicit Debugger(bool breakOnStart);
+
+    bool Active() const {
+        return armedBreakpoints || armedWatchpoints || watchIndex || !conditions.empty()
+               || mode != Mode::Run || pendingBreak || interrupted;
+    }
+
+    bool QuitRequested() const { return quitRequested; }
+
+    // Called before each instruction in the debug loop. Returns false if the user quit
+    bool BeforeExecute(Chip8 &chip8);
+
+    // Called after each instruction in the debug loop
+    void AfterExecute(Chip8 &chip8);
+
+private:
+    enum class Mode {
+        Run,
+        Step,
+        // Run until the instruction after the call, at the same stack depth
+        StepOver,
+        // Run until the current subroutine returns
+        StepOut,
+    };
+
+    struct Condition {
+        unsigned int reg;
+        std::string op;
+        uint8_t value;
+        bool lastResult;
+    };
+
+    void Repl(Chip8 &chip8);
+
+    void PrintRegisters(const Chip8 &chip8) const;
+
+    void PrintDisassembly(const Chip8 &chip8, uint16_t address, unsigned int count) const;
+
+    void PrintMemory(const Chip8 &chip8, uint16_t address, unsigned int length) const;
+
+    static bool Evaluate(const Condition &condition, const Chip8 &chip8);
+
+    static void OnInterrupt(int);
+
+    // One bit per address in memory
+    std::bitset<4096> breakpoints;
+    std::bitset<4096> watchedMemory;
+    unsigned int armedBreakpoints{};
+    unsigned int armedWatchpoints{};
+    bool watchIndex{};
+    std::vector<Condition> conditions;
+
+    Mode mode{Mode::Run};
+    unsigned int stepsLeft{};
+    uint16_t stepOverTarget{};
+    uint8_t stepDepth{};
+
+    bool pendingBreak{};
+    std::string breakReason;
+    bool quitRequested{};
+
+    // State captured by BeforeExecute for AfterExecute to compare against
+    uint16_t indexBefore{};
+    bool writesWatched{};
+
+    static volatile std::sig_atomic_t interrupted;
+};
+
+
+#endif //CHIP8_DEBUGGER_H
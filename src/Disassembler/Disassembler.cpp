@@ -0,0 +1,98 @@
+#include "Disassembler.h"
+#include <spdlog/fmt/fmt.h>
+
+std::string Disassemble(uint16_t opcode) {
+    unsigned int x = (opcode & 0x0F00u) >> 8;
+    unsigned int y = (opcode & 0x00F0u) >> 4;
+    unsigned int n = opcode & 0x000Fu;
+    unsigned int nn = opcode & 0x00FFu;
+    unsigned int nnn = opcode & 0x0FFFu;
+
+    switch ((opcode & 0xF000u) >> 12) {
+        case 0x0:
+            if (opcode == 0x00E0)
+                return "CLS";
+            if (opcode == 0x00EE)
+                return "RET";
+            break;
+        case 0x1:
+            return fmt::format("JP 0x{:03X}", nnn);
+        case 0x2:
+            return fmt::format("CALL 0x{:03X}", nnn);
+        case 0x3:
+            return fmt::format("SE V{:X}, 0x{:02X}", x, nn);
+        case 0x4:
+            return fmt::format("SNE V{:X}, 0x{:02X}", x, nn);
+        case 0x5:
+            if (n == 0)
+                return fmt::format("SE V{:X}, V{:X}", x, y);
+            break;
+        case 0x6:
+            return fmt::format("LD V{:X}, 0x{:02X}", x, nn);
+        case 0x7:
+            return fmt::format("ADD V{:X}, 0x{:02X}", x, nn);
+        case 0x8:
+            switch (n) {
+                case 0x0:
+                    return fmt::format("LD V{:X}, V{:X}", x, y);
+                case 0x1:
+                    return fmt::format("OR V{:X}, V{:X}", x, y);
+                case 0x2:
+                    return fmt::format("AND V{:X}, V{:X}", x, y);
+                case 0x3:
+                    return fmt::format("XOR V{:X}, V{:X}", x, y);
+                case 0x4:
+                    return fmt::format("ADD V{:X}, V{:X}", x, y);
+                case 0x5:
+                    return fmt::format("SUB V{:X}, V{:X}", x, y);
+                case 0x6:
+                    return fmt::format("SHR V{:X}", x);
+                case 0x7:
+                    return fmt::format("SUBN V{:X}, V{:X}", x, y);
+                case 0xE:
+                    return fmt::format("SHL V{:X}", x);
+            }
+            break;
+        case 0x9:
+            if (n == 0)
+                return fmt::format("SNE V{:X}, V{:X}", x, y);
+            break;
+        case 0xA:
+            return fmt::format("LD I, 0x{:03X}", nnn);
+        case 0xB:
+            return fmt::format("JP V0, 0x{:03X}", nnn);
+        case 0xC:
+            return fmt::format("RND V{:X}, 0x{:02X}", x, nn);
+        case 0xD:
+            return fmt::format("DRW V{:X}, V{:X}, {}", x, y, n);
+        case 0xE:
+            if (nn == 0x9E)
+                return fmt::format("SKP V{:X}", x);
+            if (nn == 0xA1)
+                return fmt::format("SKNP V{:X}", x);
+            break;
+        case 0xF:
+            switch (nn) {
+                case 0x07:
+                    return fmt::format("LD V{:X}, DT", x);
+                case 0x0A:
+                    return fmt::format("LD V{:X}, K", x);
+                case 0x15:
+                    return fmt::format("LD DT, V{:X}", x);
+                case 0x18:
+                    return fmt::format("LD ST, V{:X}", x);
+                case 0x1E:
+                    return fmt::format("ADD I, V{:X}", x);
+                case 0x29:
+                    return fmt::format("LD F, V{:X}", x);
+                case 0x33:
+                    return fmt::format("LD B, V{:X}", x);
+                case 0x55:
+                    return fmt::format("LD [I], V{:X}", x);
+                case 0x65:
+                    return fmt::format("LD V{:X}, [I]", x);
+            }
+            break;
+    }
+    return fmt::format("DW 0x{:04X}", opcode);
+}
@@ -0,0 +1,11 @@
+#ifndef CHIP8_DISASSEMBLER_H
+#define CHIP8_DISASSEMBLER_H
+
+#include <cstdint>
+#include <string>
+
+// Renders an opcode as a mnemonic, e.g. "LD V1, 0x2A". Unknown opcodes become "DW 0xNNNN"
+std::string Disassemble(uint16_t opcode);
+
+
+#endif //CHIP8_DISASSEMBLER_H
@@ -0,0 +1,202 @@
+#include "Metrics.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <utility>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../Logger/Logger.h"
+
+// A 60 Hz frame is 16.7 ms, so the frame buckets straddle that
+const std::vector<double> FRAME_BUCKETS = {0.010, 0.015, 0.0167, 0.018, 0.020, 0.025, 0.033, 0.050, 0.100, 0.250};
+const std::vector<double> DRAW_BUCKETS = {0.0001, 0.00025, 0.0005, 0.001, 0.002, 0.004, 0.008, 0.016, 0.033};
+const std::vector<double> LATENCY_BUCKETS = {0.001, 0.002, 0.005, 0.010, 0.017, 0.025, 0.033, 0.050, 0.100, 0.250};
+const int EXPORT_INTERVAL_MS = 1000;
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds{std::move(bounds)}, buckets(this->bounds.size() + 1) {}
+
+void Histogram::Observe(double seconds) {
+    size_t bucket = 0;
+    while (bucket < bounds.size() && seconds > bounds[bucket])
+        ++bucket;
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumNanoseconds.fetch_add((uint64_t) (seconds * 1e9), std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+double Histogram::Quantile(double q) const {
+    uint64_t total = Count();
+    if (total == 0)
+        return 0;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= q * total)
+            return bounds[i];
+    }
+    // Beyond the last bound, so there is no upper bound to give
+    return std::numeric_limits<double>::infinity();
+}
+
+std::string Histogram::DescribeQuantile(double q, int decimals) const {
+    double value = Quantile(q);
+    if (std::isinf(value))
+        return fmt::format("> {:.{}f} ms", bounds.back() * 1000, decimals);
+    return fmt::format("<= {:.{}f} ms", value * 1000, decimals);
+}
+
+void Histogram::Write(std::string &out, const std::string &name, const std::string &help) const {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        out += fmt::format("{}_bucket{{le=\"{}\"}} {}\n", name, bounds[i], cumulative);
+    }
+    cumulative += buckets[bounds.size()].load(std::memory_order_relaxed);
+    out += fmt::format("{}_bucket{{le=\"+Inf\"}} {}\n", name, cumulative);
+    out += fmt::format("{}_sum {}\n", name, Sum());
+    out += fmt::format("{}_count {}\n", name, cumulative);
+}
+
+static void WriteCounter(std::string &out, const std::string &name, const std::string &help, uint64_t value) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " counter\n";
+    out += fmt::format("{} {}\n", name, value);
+}
+
+Metrics::Metrics()
+    : frameInterval{FRAME_BUCKETS}, drawTime{DRAW_BUCKETS}, inputLatency{LATENCY_BUCKETS},
+      started{std::chrono::steady_clock::now()} {}
+
+std::string Metrics::Prometheus() const {
+    std::string out;
+    WriteCounter(out, "chip8_instructions_total", "Instructions executed", instructions.Value());
+    WriteCounter(out, "chip8_cycles_total", "Cycles spent according to the timing model", cycles.Value());
+    WriteCounter(out, "chip8_frames_total", "Frames run", frames.Value());
+    WriteCounter(out, "chip8_missed_frames_total", "Frames skipped because the main loop fell behind",
+                 missedFrames.Value());
+    WriteCounter(out, "chip8_key_events_total", "Keypad changes", keyEvents.Value());
+    frameInterval.Write(out, "chip8_frame_interval_seconds", "Time between consecutive frames");
+    drawTime.Write(out, "chip8_draw_seconds", "Time spent in Platform::Draw");
+    inputLatency.Write(out, "chip8_input_latency_seconds", "Time from a keypad change to the end of the next draw");
+
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    out += "# HELP chip8_uptime_seconds Time since the emulator started\n";
+    out += "# TYPE chip8_uptime_seconds gauge\n";
+    out += fmt::format("chip8_uptime_seconds {}\n", uptime);
+    return out;
+}
+
+std::string Metrics::Summary() const {
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return fmt::format("{} frames ({} missed), {:.0f} instructions/s, draw p50 {} p99 {}, "
+                       "input latency p50 {} p99 {} over {} key events",
+                       frames.Value(), missedFrames.Value(), uptime > 0 ? instructions.Value() / uptime : 0.0,
+                       drawTime.DescribeQuantile(0.5, 2), drawTime.DescribeQuantile(0.99, 2),
+                       inputLatency.DescribeQuantile(0.5, 1), inputLatency.DescribeQuantile(0.99, 1),
+                       keyEvents.Value());
+}
+
+MetricsExporter::MetricsExporter(const Metrics &metrics, const std::string &path, unsigned int port)
+    : metrics{metrics}, path{path} {
+    if (port != 0) {
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (listenSocket >= 0)
+            setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        // Loopback only; anything further afield should scrape through a proxy
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (listenSocket < 0 || bind(listenSocket, (sockaddr *) &address, sizeof(address)) != 0
+            || listen(listenSocket, 4) != 0) {
+            ERROR("Metrics endpoint on port " + std::to_string(port) + ": " + strerror(errno));
+            if (listenSocket >= 0)
+                close(listenSocket);
+            throw std::runtime_error(strerror(errno));
+        }
+        INFO("Serving metrics on http://127.0.0.1:" + std::to_string(port) + "/metrics");
+    }
+    thread = std::thread(&MetricsExporter::Run, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    running = false;
+    thread.join();
+    if (listenSocket >= 0)
+        close(listenSocket);
+    // One last write so the file reflects the whole run
+    if (!path.empty())
+        WriteFile();
+}
+
+void MetricsExporter::Run() {
+    auto nextWrite = std::chrono::steady_clock::now();
+    while (running) {
+        auto now = std::chrono::steady_clock::now();
+        if (!path.empty() && now >= nextWrite) {
+            WriteFile();
+            nextWrite = now + std::chrono::milliseconds(EXPORT_INTERVAL_MS);
+        }
+
+        if (listenSocket >= 0) {
+            // Wake at least every 100 ms so shutdown isn't held up
+            pollfd fd{listenSocket, POLLIN, 0};
+            if (poll(&fd, 1, 100) > 0)
+                Serve();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+}
+
+void MetricsExporter::WriteFile() const {
+    // Write then rename, so a scraper never sees a half written file
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file) {
+            WARN("Failed to write metrics to " + temp);
+            return;
+        }
+        file << metrics.Prometheus();
+    }
+    std::rename(temp.c_str(), path.c_str());
+}
+
+void MetricsExporter::Serve() {
+    int client = accept(listenSocket, nullptr, nullptr);
+    if (client < 0)
+        return;
+
+    // Every path gets the metrics, so the request itself only needs draining
+    char request[1024];
+    pollfd fd{client, POLLIN, 0};
+    if (poll(&fd, 1, 100) > 0)
+        recv(client, request, sizeof(request), 0);
+
+    std::string body = metrics.Prometheus();
+    std::string response = "HTTP/1.0 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            break;
+        sent += n;
+    }
+    close(client);
+}
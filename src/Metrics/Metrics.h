@@ -0,0 +1,97 @@
+#ifndef CHIP8_METRICS_H
+#define CHIP8_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Monotonic count. Relaxed atomics: readers only need an eventually consistent snapshot
+class Counter {
+public:
+    void Add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+
+    uint64_t Value() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{};
+};
+
+// Fixed-bucket histogram of durations in seconds
+class Histogram {
+public:
+    // Upper bounds of each bucket in ascending order; an overflow bucket is added on top
+    explicit Histogram(std::vector<double> bounds);
+
+    void Observe(double seconds);
+
+    uint64_t Count() const { return count.load(std::memory_order_relaxed); }
+
+    double Sum() const { return sumNanoseconds.load(std::memory_order_relaxed) / 1e9; }
+
+    // Estimated from the buckets, so only as precise as the bucket bounds. +Inf when it lands in the overflow bucket
+    double Quantile(double q) const;
+
+    // Quantile in milliseconds for humans, e.g. "<= 2.00 ms", or "> 33.00 ms" past the last bound
+    std::string DescribeQuantile(double q, int decimals) const;
+
+    void Write(std::string &out, const std::string &name, const std::string &help) const;
+
+private:
+    std::vector<double> bounds;
+    std::vector<std::atomic<uint64_t>> buckets;
+    std::atomic<uint64_t> count{};
+    std::atomic<uint64_t> sumNanoseconds{};
+};
+
+struct Metrics {
+    Metrics();
+
+    Counter instructions;
+    Counter cycles;
+    Counter frames;
+    // Frames the main loop fell too far behind to run
+    Counter missedFrames;
+    Counter keyEvents;
+
+    // Time between the starts of consecutive frames
+    Histogram frameInterval;
+    Histogram drawTime;
+    // From the keypad changing to the end of the next Draw
+    Histogram inputLatency;
+
+    std::chrono::steady_clock::time_point started;
+
+    // Prometheus text exposition format
+    std::string Prometheus() const;
+
+    // Human readable summary for the log at exit
+    std::string Summary() const;
+};
+
+// Publishes metrics from a background thread, to a file rewritten every second and/or a loopback HTTP endpoint
+class MetricsExporter {
+public:
+    // Empty path or port 0 disables that output
+    MetricsExporter(const Metrics &metrics, const std::string &path, unsigned int port);
+
+    ~MetricsExporter();
+
+private:
+    void Run();
+
+    void WriteFile() const;
+
+    void Serve();
+
+    const Metrics &metrics;
+    std::string path;
+    int listenSocket{-1};
+    std::atomic<bool> running{true};
+    std::thread thread;
+};
+
+
+#endif //CHIP8_METRICS_H
@@ -0,0 +1,7 @@
+#include "HeadlessPlatform.h"
+
+bool HeadlessPlatform::HandleInput(uint8_t *keypad) {
+    return true;
+}
+
+void HeadlessPlatform::Draw(const uint32_t *display) {}
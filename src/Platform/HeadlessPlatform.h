@@ -0,0 +1,15 @@
+#ifndef CHIP8_HEADLESSPLATFORM_H
+#define CHIP8_HEADLESSPLATFORM_H
+
+#include "Platform.h"
+
+// No window and no input, for batch runs and servers without a display
+class HeadlessPlatform : public Platform {
+public:
+    bool HandleInput(uint8_t *keypad) override;
+
+    void Draw(const uint32_t *display) override;
+};
+
+
+#endif //CHIP8_HEADLESSPLATFORM_H
@@ -1,30 +1,17 @@
-//
-// Created by Noah Fournier on 23/08/2022.
-//
-
 #ifndef CHIP8_PLATFORM_H
 #define CHIP8_PLATFORM_H
 
-#include <SDL2/SDL.h>
-#include <string>
+#include <cstdint>
 
+// Output and input backend the main loop drives, e.g. an SDL window or a terminal
 class Platform {
 public:
-    Platform(const std::string &title, unsigned int windowWidth, unsigned int windowHeight, unsigned int videoPitch);
-
-    ~Platform();
-
-    unsigned int videoPitch;
-
-    bool HandleInput(uint8_t *keypad) const;
-
-    void Draw(const uint32_t *display);
+    virtual ~Platform() = default;
 
-private:
-    SDL_Window *window;
-    SDL_Renderer *renderer;
-    SDL_Texture *texture;
+    // Updates keypad from pending input. Returns false once the user asks to quit
+    virtual bool HandleInput(uint8_t *keypad) = 0;
 
+    virtual void Draw(const uint32_t *display) = 0;
 };
 
 
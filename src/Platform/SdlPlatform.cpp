@@ -1,18 +1,22 @@
-#include "Platform.h"
+#include "SdlPlatform.h"
 #include "../Logger/Logger.h"
 #include <SDL2/SDL.h>
 
-Platform::Platform(const std::string &title, unsigned int windowWidth, unsigned int windowHeight, unsigned int videoPitch)
-    : videoPitch{videoPitch} {
+SdlPlatform::SdlPlatform(const std::string &title, unsigned int windowWidth, unsigned int windowHeight,
+                         const PresenterOptions &options)
+    : presenter{std::make_unique<Presenter>(windowWidth, windowHeight, options)} {
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         ERROR("SDL_Init: ", SDL_GetError());
         throw std::runtime_error(SDL_GetError());
     }
 
+    // CPU scalers size the window to their output so it is shown 1:1
+    bool gpuScaled = options.scaler == Scaler::Gpu;
     window = SDL_CreateWindow(title.c_str(),
                               SDL_WINDOWPOS_CENTERED,
                               SDL_WINDOWPOS_CENTERED,
-                              windowWidth * 10, windowHeight * 10, SDL_WINDOW_SHOWN);
+                              gpuScaled ? windowWidth * options.scale : presenter->OutputWidth(),
+                              gpuScaled ? windowHeight * options.scale : presenter->OutputHeight(), SDL_WINDOW_SHOWN);
     if (!window) {
         ERROR("SDL_CreateWindow: ", SDL_GetError());
         throw std::runtime_error(SDL_GetError());
@@ -24,22 +28,23 @@ Platform::Platform(const std::string &title, unsigned int windowWidth, unsigned
         throw std::runtime_error(SDL_GetError());
     }
 
+    // The presenter does any CPU scaling, so the texture matches its output; with the GPU scaler the renderer stretches it
     texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING,
-                                windowWidth, windowHeight);
+                                presenter->OutputWidth(), presenter->OutputHeight());
     if (!texture) {
         ERROR("SDLCreateTexture: ", SDL_GetError());
         throw std::runtime_error(SDL_GetError());
     }
 }
 
-Platform::~Platform() {
+SdlPlatform::~SdlPlatform() {
     SDL_DestroyTexture(texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 }
 
-bool Platform::HandleInput(uint8_t* keypad) const {
+bool SdlPlatform::HandleInput(uint8_t* keypad) {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch(event.type) {
@@ -158,8 +163,17 @@ bool Platform::HandleInput(uint8_t* keypad) const {
     return true;
 }
 
-void Platform::Draw(const uint32_t *display) {
-    SDL_UpdateTexture(texture, nullptr, display, videoPitch);
+void SdlPlatform::Draw(const uint32_t *display) {
+    // Write straight into the streaming texture rather than staging a copy for SDL_UpdateTexture
+    void *pixels;
+    int pitch;
+    if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) != 0) {
+        ERROR("SDL_LockTexture: ", SDL_GetError());
+        return;
+    }
+    presenter->Present(display, pixels, pitch);
+    SDL_UnlockTexture(texture);
+
     SDL_RenderClear(renderer);
     SDL_RenderCopy(renderer, texture, nullptr, nullptr);
     SDL_RenderPresent(renderer);
@@ -0,0 +1,34 @@
+//
+// Created by Noah Fournier on 23/08/2022.
+//
+
+#ifndef CHIP8_SDLPLATFORM_H
+#define CHIP8_SDLPLATFORM_H
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+#include "Platform.h"
+#include "../Presenter/Presenter.h"
+
+class SdlPlatform : public Platform {
+public:
+    SdlPlatform(const std::string &title, unsigned int windowWidth, unsigned int windowHeight,
+                const PresenterOptions &options = {});
+
+    ~SdlPlatform() override;
+
+    bool HandleInput(uint8_t *keypad) override;
+
+    void Draw(const uint32_t *display) override;
+
+private:
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    std::unique_ptr<Presenter> presenter;
+
+};
+
+
+#endif //CHIP8_SDLPLATFORM_H
@@ -0,0 +1,250 @@
+#include "TerminalPlatform.h"
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "../Logger/Logger.h"
+
+// Until a key starts auto-repeating we can't tell a tap from a hold, so give it the repeat delay
+const auto KEY_FIRST_HOLD = std::chrono::milliseconds(300);
+const auto KEY_REPEAT_HOLD = std::chrono::milliseconds(100);
+// How long a lone escape waits for the rest of a sequence before it counts as quit
+const auto ESCAPE_TIMEOUT = std::chrono::milliseconds(300);
+const uint8_t KEY_ESCAPE = 0x1B;
+const uint8_t KEY_CTRL_C = 0x03;
+
+CellMode ParseCellMode(const std::string &name) {
+    if (name == "half")
+        return CellMode::HalfBlock;
+    if (name == "braille")
+        return CellMode::Braille;
+    ERROR("Unknown cell mode: " + name);
+    throw std::invalid_argument("Unknown cell mode: " + name);
+}
+
+// Same layout as the SDL keyboard mapping
+static int KeyFor(uint8_t c) {
+    switch (std::tolower(c)) {
+        case '1': return 0x1;
+        case '2': return 0x2;
+        case '3': return 0x3;
+        case '4': return 0xC;
+        case 'q': return 0x4;
+        case 'w': return 0x5;
+        case 'e': return 0x6;
+        case 'r': return 0xD;
+        case 'a': return 0x7;
+        case 's': return 0x8;
+        case 'd': return 0x9;
+        case 'f': return 0xE;
+        case 'z': return 0xA;
+        case 'x': return 0x0;
+        case 'c': return 0xB;
+        case 'v': return 0xF;
+        default: return -1;
+    }
+}
+
+static void AppendCodepoint(std::string &out, uint32_t codepoint) {
+    // All glyphs used here sit in the three byte UTF-8 range
+    out += (char) (0xE0u | (codepoint >> 12));
+    out += (char) (0x80u | ((codepoint >> 6) & 0x3Fu));
+    out += (char) (0x80u | (codepoint & 0x3Fu));
+}
+
+static void AppendGlyph(std::string &out, CellMode mode, uint8_t cell) {
+    if (mode == CellMode::Braille) {
+        // A blank braille cell renders narrower than a space on some fonts, so use a space
+        if (cell == 0)
+            out += ' ';
+        else
+            AppendCodepoint(out, 0x2800u + cell);
+        return;
+    }
+    switch (cell) {
+        case 0:
+            out += ' ';
+            break;
+        case 1:
+            AppendCodepoint(out, 0x2580u); // upper half
+            break;
+        case 2:
+            AppendCodepoint(out, 0x2584u); // lower half
+            break;
+        default:
+            AppendCodepoint(out, 0x2588u); // full block
+            break;
+    }
+}
+
+TerminalPlatform::TerminalPlatform(unsigned int width, unsigned int height, CellMode mode)
+    : width{width}, height{height}, mode{mode},
+      columns{mode == CellMode::Braille ? (width + 1) / 2 : width},
+      rows{mode == CellMode::Braille ? (height + 3) / 4 : (height + 1) / 2},
+      shown(columns * rows), cells(columns * rows) {
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+        ERROR("Terminal platform needs stdin and stdout to be a terminal");
+        throw std::runtime_error("Not a terminal");
+    }
+
+    struct winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && (size.ws_col < columns || size.ws_row < rows)) {
+        WARN("Terminal is smaller than the " + std::to_string(columns) + "x" + std::to_string(rows) + " cells needed");
+    }
+
+    if (tcgetattr(STDIN_FILENO, &savedTermios) != 0) {
+        ERROR("tcgetattr: ", strerror(errno));
+        throw std::runtime_error(strerror(errno));
+    }
+    struct termios raw = savedTermios;
+    // No echo, no line buffering, and Ctrl-C arrives as a byte rather than a signal so we can restore the terminal
+    raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+
+    // Never let a slow link stall the emulator; Flush() drops frames instead
+    savedStdinFlags = fcntl(STDIN_FILENO, F_GETFL);
+    savedStdoutFlags = fcntl(STDOUT_FILENO, F_GETFL);
+    fcntl(STDIN_FILENO, F_SETFL, savedStdinFlags | O_NONBLOCK);
+    fcntl(STDOUT_FILENO, F_SETFL, savedStdoutFlags | O_NONBLOCK);
+
+    // Alternate screen, hide the cursor, clear. Every cell now matches the zeroed `shown`
+    pending = "\x1b[?1049h\x1b[?25l\x1b[2J";
+    Flush();
+}
+
+TerminalPlatform::~TerminalPlatform() {
+    fcntl(STDOUT_FILENO, F_SETFL, savedStdoutFlags);
+    fcntl(STDIN_FILENO, F_SETFL, savedStdinFlags);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedTermios);
+
+    // Anything still queued is a stale frame; just restore the screen
+    const char restore[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+    if (write(STDOUT_FILENO, restore, sizeof(restore) - 1) < 0) {
+        WARN("Failed to restore terminal: ", strerror(errno));
+    }
+}
+
+bool TerminalPlatform::HandleInput(uint8_t *keypad) {
+    auto now = Clock::now();
+    uint8_t buffer[64];
+    ssize_t count;
+    while ((count = read(STDIN_FILENO, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t i = 0; i < count; ++i) {
+            uint8_t c = buffer[i];
+            if (c == KEY_CTRL_C)
+                return false;
+            if (escape == EscapeState::Sequence) {
+                if (c >= 0x40 && c <= 0x7E)
+                    escape = EscapeState::None;
+                continue;
+            }
+            if (escape == EscapeState::Escape) {
+                // Arrow keys and the like are skipped; anything else was just ESC followed by a key
+                escape = EscapeState::None;
+                if (c == '[' || c == 'O') {
+                    escape = EscapeState::Sequence;
+                    continue;
+                }
+            }
+            if (c == KEY_ESCAPE) {
+                escape = EscapeState::Escape;
+                escapeTime = now;
+                continue;
+            }
+
+            int key = KeyFor(c);
+            if (key < 0)
+                continue;
+            // A second press while still down means the terminal is auto-repeating it
+            repeating[key] = keypad[key] == 1;
+            keypad[key] = 1;
+            lastPressed[key] = now;
+        }
+    }
+
+    if (escape == EscapeState::Escape && now - escapeTime > ESCAPE_TIMEOUT)
+        return false;
+
+    for (int key = 0; key < 16; ++key) {
+        if (!keypad[key])
+            continue;
+        auto hold = repeating[key] ? KEY_REPEAT_HOLD : KEY_FIRST_HOLD;
+        if (now - lastPressed[key] > hold) {
+            keypad[key] = 0;
+            repeating[key] = false;
+        }
+    }
+    return true;
+}
+
+void TerminalPlatform::BuildCells(const uint32_t *display) {
+    for (unsigned int row = 0; row < rows; ++row) {
+        for (unsigned int col = 0; col < columns; ++col) {
+            uint8_t cell = 0;
+            if (mode == CellMode::Braille) {
+                // Braille dot bits, indexed by [y][x] within the 2x4 cell
+                static const uint8_t DOTS[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+                for (unsigned int y = 0; y < 4; ++y) {
+                    for (unsigned int x = 0; x < 2; ++x) {
+                        unsigned int px = col * 2 + x, py = row * 4 + y;
+                        if (px < width && py < height && display[py * width + px])
+                            cell |= DOTS[y][x];
+                    }
+                }
+            } else {
+                unsigned int top = row * 2;
+                if (display[top * width + col])
+                    cell |= 1;
+                if (top + 1 < height && display[(top + 1) * width + col])
+                    cell |= 2;
+            }
+            cells[row * columns + col] = cell;
+        }
+    }
+}
+
+void TerminalPlatform::Draw(const uint32_t *display) {
+    // While the previous frame is still draining, skip this one rather than queueing behind it
+    if (!pending.empty()) {
+        Flush();
+        if (!pending.empty())
+            return;
+    }
+
+    BuildCells(display);
+
+    // Emit only the changed cells, moving the cursor only when they aren't contiguous
+    size_t cursor = SIZE_MAX;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (cells[i] == shown[i])
+            continue;
+        if (cursor != i) {
+            pending += "\x1b[" + std::to_string(i / columns + 1) + ";" + std::to_string(i % columns + 1) + "H";
+        }
+        AppendGlyph(pending, mode, cells[i]);
+        shown[i] = cells[i];
+        // At the end of a row the cursor doesn't wrap, so its position is no longer known
+        cursor = (i + 1) % columns == 0 ? SIZE_MAX : i + 1;
+    }
+    Flush();
+}
+
+void TerminalPlatform::Flush() {
+    size_t written = 0;
+    while (written < pending.size()) {
+        ssize_t count = write(STDOUT_FILENO, pending.data() + written, pending.size() - written);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        written += count;
+    }
+    pending.erase(0, written);
+}
@@ -0,0 +1,70 @@
+#ifndef CHIP8_TERMINALPLATFORM_H
+#define CHIP8_TERMINALPLATFORM_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <termios.h>
+#include "Platform.h"
+
+enum class CellMode {
+    // 1x2 pixels per cell using the upper / lower half block characters
+    HalfBlock,
+    // 2x4 pixels per cell using braille patterns
+    Braille,
+};
+
+CellMode ParseCellMode(const std::string &name);
+
+// Draws into the terminal with ANSI escapes and reads keys from raw stdin, e.g. over SSH
+class TerminalPlatform : public Platform {
+public:
+    TerminalPlatform(unsigned int width, unsigned int height, CellMode mode);
+
+    ~TerminalPlatform() override;
+
+    bool HandleInput(uint8_t *keypad) override;
+
+    void Draw(const uint32_t *display) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void BuildCells(const uint32_t *display);
+
+    // Writes as much pending output as the terminal accepts without blocking
+    void Flush();
+
+    unsigned int width;
+    unsigned int height;
+    CellMode mode;
+    unsigned int columns;
+    unsigned int rows;
+
+    // What the terminal is showing, and what the current frame wants it to show
+    std::vector<uint8_t> shown;
+    std::vector<uint8_t> cells;
+    std::string pending;
+
+    // Terminals only report key presses, so a key is released once it stops repeating
+    Clock::time_point lastPressed[16]{};
+    bool repeating[16]{};
+
+    // Escape sequences can be split across reads on a slow link, so parsing state outlives HandleInput
+    enum class EscapeState {
+        None,
+        // Saw ESC; quits unless more of a sequence turns up in time
+        Escape,
+        // Inside a CSI / SS3 sequence, skipping to its final byte
+        Sequence,
+    };
+    EscapeState escape{EscapeState::None};
+    Clock::time_point escapeTime{};
+
+    struct termios savedTermios{};
+    int savedStdinFlags{};
+    int savedStdoutFlags{};
+};
+
+
+#endif //CHIP8_TERMINALPLATFORM_H
@@ -0,0 +1,340 @@
+#include "Presenter.h"
+#include <cstring>
+#include <stdexcept>
+#include "../Logger/Logger.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// AVX2 kernels are compiled with a target attribute and only picked when the CPU supports them
+#if defined(__GNUC__) && defined(__SSE2__)
+#define CHIP8_HAVE_AVX2 1
+#define CHIP8_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+Scaler ParseScaler(const std::string &name) {
+    if (name == "gpu")
+        return Scaler::Gpu;
+    if (name == "nearest")
+        return Scaler::Nearest;
+    if (name == "scale2x")
+        return Scaler::Scale2x;
+    if (name == "scale3x")
+        return Scaler::Scale3x;
+    ERROR("Unknown scaler: " + name);
+    throw std::invalid_argument("Unknown scaler: " + name);
+}
+
+Palette ParsePalette(const std::string &name) {
+    if (name == "mono")
+        return {0xFFFFFF, 0x000000};
+    if (name == "amber")
+        return {0xFFB000, 0x1A0F00};
+    if (name == "green")
+        return {0x33FF66, 0x001A08};
+    if (name == "lcd")
+        return {0x0F380F, 0x9BBC0F};
+    ERROR("Unknown palette: " + name);
+    throw std::invalid_argument("Unknown palette: " + name);
+}
+
+// Display pixels are either all zeroes or all ones, so they double as a select mask
+
+static void MapPaletteScalar(const uint32_t *src, uint32_t *dst, size_t count, Palette palette) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (src[i] & palette.foreground) | (~src[i] & palette.background);
+    }
+}
+
+static void ExpandRowScalar(const uint32_t *src, size_t count, unsigned int factor, uint32_t *dst) {
+    for (size_t i = 0; i < count; ++i) {
+        for (unsigned int k = 0; k < factor; ++k) {
+            *dst++ = src[i];
+        }
+    }
+}
+
+static void DarkenRowScalar(const uint32_t *src, uint32_t *dst, size_t count) {
+    // Halve every channel; the mask stops bits shifting into the channel below
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (src[i] >> 1) & 0x7F7F7F7Fu;
+    }
+}
+
+#ifdef __SSE2__
+
+static void MapPaletteSse2(const uint32_t *src, uint32_t *dst, size_t count, Palette palette) {
+    const __m128i fg = _mm_set1_epi32((int) palette.foreground);
+    const __m128i bg = _mm_set1_epi32((int) palette.background);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i out = _mm_or_si128(_mm_and_si128(p, fg), _mm_andnot_si128(p, bg));
+        _mm_storeu_si128((__m128i *) (dst + i), out);
+    }
+    MapPaletteScalar(src + i, dst + i, count - i, palette);
+}
+
+static void ExpandRowSse2(const uint32_t *src, size_t count, unsigned int factor, uint32_t *dst) {
+    if (factor == 2) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i p = _mm_loadu_si128((const __m128i *) (src + i));
+            _mm_storeu_si128((__m128i *) (dst + 2 * i), _mm_unpacklo_epi32(p, p));
+            _mm_storeu_si128((__m128i *) (dst + 2 * i + 4), _mm_unpackhi_epi32(p, p));
+        }
+        ExpandRowScalar(src + i, count - i, factor, dst + 2 * i);
+        return;
+    }
+    if (factor < 4) {
+        ExpandRowScalar(src, count, factor, dst);
+        return;
+    }
+
+    // Fill each run with 4-wide stores; the last store is pulled back to overlap instead of spilling over
+    for (size_t i = 0; i < count; ++i) {
+        __m128i p = _mm_set1_epi32((int) src[i]);
+        uint32_t *run = dst + i * factor;
+        for (unsigned int k = 0; k + 4 < factor; k += 4) {
+            _mm_storeu_si128((__m128i *) (run + k), p);
+        }
+        _mm_storeu_si128((__m128i *) (run + factor - 4), p);
+    }
+}
+
+static void DarkenRowSse2(const uint32_t *src, uint32_t *dst, size_t count) {
+    const __m128i mask = _mm_set1_epi32(0x7F7F7F7F);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_and_si128(_mm_srli_epi32(p, 1), mask));
+    }
+    DarkenRowScalar(src + i, dst + i, count - i);
+}
+
+#endif
+
+#ifdef CHIP8_HAVE_AVX2
+
+CHIP8_TARGET_AVX2
+static void MapPaletteAvx2(const uint32_t *src, uint32_t *dst, size_t count, Palette palette) {
+    const __m256i fg = _mm256_set1_epi32((int) palette.foreground);
+    const __m256i bg = _mm256_set1_epi32((int) palette.background);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *) (src + i));
+        __m256i out = _mm256_or_si256(_mm256_and_si256(p, fg), _mm256_andnot_si256(p, bg));
+        _mm256_storeu_si256((__m256i *) (dst + i), out);
+    }
+    MapPaletteScalar(src + i, dst + i, count - i, palette);
+}
+
+CHIP8_TARGET_AVX2
+static void ExpandRowAvx2(const uint32_t *src, size_t count, unsigned int factor, uint32_t *dst) {
+    if (factor < 8) {
+        ExpandRowSse2(src, count, factor, dst);
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        __m256i p = _mm256_set1_epi32((int) src[i]);
+        uint32_t *run = dst + i * factor;
+        for (unsigned int k = 0; k + 8 < factor; k += 8) {
+            _mm256_storeu_si256((__m256i *) (run + k), p);
+        }
+        _mm256_storeu_si256((__m256i *) (run + factor - 8), p);
+    }
+}
+
+CHIP8_TARGET_AVX2
+static void DarkenRowAvx2(const uint32_t *src, uint32_t *dst, size_t count) {
+    const __m256i mask = _mm256_set1_epi32(0x7F7F7F7F);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *) (src + i));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_and_si256(_mm256_srli_epi32(p, 1), mask));
+    }
+    DarkenRowScalar(src + i, dst + i, count - i);
+}
+
+#endif
+
+// EPX / Scale2x. src points at the first interior pixel of a frame with a one pixel border
+static void Scale2x(const uint32_t *src, size_t stride, unsigned int width, unsigned int height, uint32_t *dst) {
+    const size_t dstWidth = width * 2;
+    for (unsigned int y = 0; y < height; ++y) {
+        const uint32_t *row = src + y * stride;
+        const uint32_t *above = row - stride;
+        const uint32_t *below = row + stride;
+        uint32_t *out0 = dst + (2 * y) * dstWidth;
+        uint32_t *out1 = out0 + dstWidth;
+        unsigned int x = 0;
+#ifdef __SSE2__
+        for (; x + 4 <= width; x += 4) {
+            __m128i b = _mm_loadu_si128((const __m128i *) (above + x));
+            __m128i d = _mm_loadu_si128((const __m128i *) (row + x - 1));
+            __m128i e = _mm_loadu_si128((const __m128i *) (row + x));
+            __m128i f = _mm_loadu_si128((const __m128i *) (row + x + 1));
+            __m128i h = _mm_loadu_si128((const __m128i *) (below + x));
+
+            __m128i db = _mm_cmpeq_epi32(d, b);
+            __m128i bf = _mm_cmpeq_epi32(b, f);
+            __m128i dh = _mm_cmpeq_epi32(d, h);
+            __m128i hf = _mm_cmpeq_epi32(h, f);
+
+            // e0: D==B && B!=F && D!=H, e1: B==F && B!=D && F!=H, etc.
+            __m128i m0 = _mm_andnot_si128(_mm_or_si128(bf, dh), db);
+            __m128i m1 = _mm_andnot_si128(_mm_or_si128(db, hf), bf);
+            __m128i m2 = _mm_andnot_si128(_mm_or_si128(db, hf), dh);
+            __m128i m3 = _mm_andnot_si128(_mm_or_si128(dh, bf), hf);
+
+            __m128i e0 = _mm_or_si128(_mm_and_si128(m0, d), _mm_andnot_si128(m0, e));
+            __m128i e1 = _mm_or_si128(_mm_and_si128(m1, f), _mm_andnot_si128(m1, e));
+            __m128i e2 = _mm_or_si128(_mm_and_si128(m2, d), _mm_andnot_si128(m2, e));
+            __m128i e3 = _mm_or_si128(_mm_and_si128(m3, f), _mm_andnot_si128(m3, e));
+
+            _mm_storeu_si128((__m128i *) (out0 + 2 * x), _mm_unpacklo_epi32(e0, e1));
+            _mm_storeu_si128((__m128i *) (out0 + 2 * x + 4), _mm_unpackhi_epi32(e0, e1));
+            _mm_storeu_si128((__m128i *) (out1 + 2 * x), _mm_unpacklo_epi32(e2, e3));
+            _mm_storeu_si128((__m128i *) (out1 + 2 * x + 4), _mm_unpackhi_epi32(e2, e3));
+        }
+#endif
+        for (; x < width; ++x) {
+            const uint32_t *m = row + x;
+            uint32_t b = above[x], d = m[-1], e = m[0], f = m[1], h = below[x];
+            out0[2 * x] = d == b && b != f && d != h ? d : e;
+            out0[2 * x + 1] = b == f && b != d && f != h ? f : e;
+            out1[2 * x] = d == h && d != b && h != f ? d : e;
+            out1[2 * x + 1] = h == f && d != h && b != f ? f : e;
+        }
+    }
+}
+
+// Scale3x only runs over the 64x32 source, so the scalar version is already far below the frame budget
+static void Scale3x(const uint32_t *src, size_t stride, unsigned int width, unsigned int height, uint32_t *dst) {
+    const size_t dstWidth = width * 3;
+    for (unsigned int y = 0; y < height; ++y) {
+        const uint32_t *row = src + y * stride;
+        const uint32_t *above = row - stride;
+        const uint32_t *below = row + stride;
+        uint32_t *out0 = dst + (3 * y) * dstWidth;
+        uint32_t *out1 = out0 + dstWidth;
+        uint32_t *out2 = out1 + dstWidth;
+        for (unsigned int x = 0; x < width; ++x) {
+            const uint32_t *n = above + x, *m = row + x, *s = below + x;
+            uint32_t a = n[-1], b = n[0], c = n[1];
+            uint32_t d = m[-1], e = m[0], f = m[1];
+            uint32_t g = s[-1], h = s[0], i = s[1];
+
+            bool db = d == b && b != f && d != h;
+            bool bf = b == f && b != d && f != h;
+            bool dh = d == h && d != b && h != f;
+            bool hf = h == f && d != h && b != f;
+
+            out0[3 * x] = db ? d : e;
+            out0[3 * x + 1] = (db && e != c) || (bf && e != a) ? b : e;
+            out0[3 * x + 2] = bf ? f : e;
+            out1[3 * x] = (db && e != g) || (dh && e != a) ? d : e;
+            out1[3 * x + 1] = e;
+            out1[3 * x + 2] = (bf && e != i) || (hf && e != c) ? f : e;
+            out2[3 * x] = dh ? d : e;
+            out2[3 * x + 1] = (dh && e != i) || (hf && e != g) ? h : e;
+            out2[3 * x + 2] = hf ? f : e;
+        }
+    }
+}
+
+Presenter::Presenter(unsigned int width, unsigned int height, const PresenterOptions &options)
+    : width{width}, height{height}, options{options},
+      padded((width + 2) * (height + 2)) {
+    switch (options.scaler) {
+        case Scaler::Gpu:
+            epxFactor = 1;
+            nearestFactor = 1;
+            break;
+        case Scaler::Nearest:
+            epxFactor = 1;
+            nearestFactor = options.scale;
+            break;
+        case Scaler::Scale2x:
+        case Scaler::Scale3x:
+            // EPX first, then make up the rest of the scale with nearest neighbour. Rounded up, and the
+            // window follows, so the renderer never has to stretch by a fraction
+            epxFactor = options.scaler == Scaler::Scale2x ? 2 : 3;
+            nearestFactor = (options.scale + epxFactor - 1) / epxFactor;
+            break;
+    }
+    if (nearestFactor == 0)
+        nearestFactor = 1;
+    if (epxFactor > 1)
+        epx.resize(width * epxFactor * height * epxFactor);
+
+    mapPalette = MapPaletteScalar;
+    expandRow = ExpandRowScalar;
+    darkenRow = DarkenRowScalar;
+#ifdef __SSE2__
+    mapPalette = MapPaletteSse2;
+    expandRow = ExpandRowSse2;
+    darkenRow = DarkenRowSse2;
+#endif
+#ifdef CHIP8_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        mapPalette = MapPaletteAvx2;
+        expandRow = ExpandRowAvx2;
+        darkenRow = DarkenRowAvx2;
+    }
+#endif
+}
+
+void Presenter::Present(const uint32_t *display, void *dst, int pitch) {
+    const size_t stride = width + 2;
+    uint32_t *interior = padded.data() + stride + 1;
+
+    for (unsigned int y = 0; y < height; ++y) {
+        uint32_t *row = interior + y * stride;
+        mapPalette(display + y * width, row, width, options.palette);
+        // Repeat the edge pixels into the border
+        row[-1] = row[0];
+        row[width] = row[width - 1];
+    }
+    memcpy(padded.data(), padded.data() + stride, stride * sizeof(uint32_t));
+    memcpy(padded.data() + (height + 1) * stride, padded.data() + height * stride, stride * sizeof(uint32_t));
+
+    const uint32_t *source = interior;
+    size_t sourceStride = stride;
+    unsigned int sourceWidth = width;
+    unsigned int sourceHeight = height;
+    if (epxFactor == 2) {
+        Scale2x(interior, stride, width, height, epx.data());
+    } else if (epxFactor == 3) {
+        Scale3x(interior, stride, width, height, epx.data());
+    }
+    if (epxFactor > 1) {
+        source = epx.data();
+        sourceWidth = width * epxFactor;
+        sourceHeight = height * epxFactor;
+        sourceStride = sourceWidth;
+    }
+
+    auto *out = static_cast<uint8_t *>(dst);
+    const size_t outWidth = sourceWidth * nearestFactor;
+    for (unsigned int y = 0; y < sourceHeight; ++y) {
+        size_t firstLine = y * nearestFactor;
+        auto *first = reinterpret_cast<uint32_t *>(out + firstLine * pitch);
+        expandRow(source + y * sourceStride, sourceWidth, nearestFactor, first);
+
+        // Replicate the scaled line, darkening odd lines when scanlines are on
+        for (unsigned int k = 1; k < nearestFactor; ++k) {
+            auto *line = reinterpret_cast<uint32_t *>(out + (firstLine + k) * pitch);
+            if (options.scanlines && ((firstLine + k) & 1u)) {
+                darkenRow(first, line, outWidth);
+            } else {
+                memcpy(line, first, outWidth * sizeof(uint32_t));
+            }
+        }
+        if (options.scanlines && (firstLine & 1u)) {
+            darkenRow(first, first, outWidth);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef CHIP8_PRESENTER_H
+#define CHIP8_PRESENTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class Scaler {
+    // Upload the 64x32 frame and let the renderer stretch it
+    Gpu,
+    Nearest,
+    Scale2x,
+    Scale3x,
+};
+
+struct Palette {
+    uint32_t foreground;
+    uint32_t background;
+};
+
+struct PresenterOptions {
+    Scaler scaler = Scaler::Gpu;
+    unsigned int scale = 10;
+    bool scanlines = false;
+    Palette palette{0xFFFFFF, 0x000000};
+};
+
+Scaler ParseScaler(const std::string &name);
+
+Palette ParsePalette(const std::string &name);
+
+// Converts the display buffer into RGB888 pixels, scaling and filtering on the CPU
+class Presenter {
+public:
+    Presenter(unsigned int width, unsigned int height, const PresenterOptions &options);
+
+    unsigned int OutputWidth() const { return width * epxFactor * nearestFactor; }
+
+    unsigned int OutputHeight() const { return height * epxFactor * nearestFactor; }
+
+    // Writes OutputWidth() x OutputHeight() pixels to dst, pitch given in bytes
+    void Present(const uint32_t *display, void *dst, int pitch);
+
+private:
+    using MapPaletteFn = void (*)(const uint32_t *src, uint32_t *dst, size_t count, Palette palette);
+    using ExpandRowFn = void (*)(const uint32_t *src, size_t count, unsigned int factor, uint32_t *dst);
+    using DarkenRowFn = void (*)(const uint32_t *src, uint32_t *dst, size_t count);
+
+    unsigned int width;
+    unsigned int height;
+    PresenterOptions options;
+    unsigned int epxFactor;
+    unsigned int nearestFactor;
+
+    // Palette-mapped frame with a one pixel border, so EPX never reads out of bounds
+    std::vector<uint32_t> padded;
+    std::vector<uint32_t> epx;
+
+    MapPaletteFn mapPalette;
+    ExpandRowFn expandRow;
+    DarkenRowFn darkenRow;
+};
+
+
+#endif //CHIP8_PRESENTER_H
@@ -0,0 +1,88 @@
+#include "Rom.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <ios>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../Chip8/Chip8.h"
+#include "../Logger/Logger.h"
+
+RomImage::RomImage(const uint8_t *data, size_t size) : bytes(data, data + size), hash{HashRom(bytes.data(), bytes.size())} {}
+
+uint64_t HashRom(const uint8_t *data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001B3u;
+    }
+    return hash;
+}
+
+RomCache &RomCache::Global() {
+    static RomCache cache;
+    return cache;
+}
+
+std::shared_ptr<const RomImage> RomCache::Load(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ERROR("Failed to open ROM: " + path);
+        throw std::ios::failure(strerror(errno));
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        ERROR("Failed to stat ROM: " + path);
+        throw std::ios::failure(strerror(error));
+    }
+
+    if (info.st_size <= 0 || (size_t) info.st_size > MAX_ROM_SIZE) {
+        close(fd);
+        ERROR("ROM " + path + " is " + std::to_string(info.st_size) + " bytes, expected 1 to "
+              + std::to_string(MAX_ROM_SIZE));
+        throw std::ios::failure("ROM size out of range");
+    }
+    size_t size = info.st_size;
+
+    FileKey fileKey{info.st_dev, info.st_ino, info.st_mtim.tv_sec, info.st_mtim.tv_nsec, size};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto cached = byFile.find(fileKey);
+        if (cached != byFile.end()) {
+            close(fd);
+            return cached->second;
+        }
+    }
+
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        ERROR("Failed to map ROM: " + path);
+        throw std::ios::failure(strerror(error));
+    }
+
+    // ROMs are a few KB, so copying is cheap. A mapping would keep tracking the file, so a cached image
+    // could change under every path sharing it, or SIGBUS if the file were truncated
+    auto image = std::make_shared<const RomImage>(static_cast<const uint8_t *>(mapping), size);
+    munmap(mapping, size);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &shared = byHash[image->Hash()];
+    if (!shared) {
+        shared = image;
+    } else if (shared->Size() == size && memcmp(shared->Data(), image->Data(), size) == 0) {
+        // Same contents under another name; drop our copy and share the cached one
+        image = shared;
+    } else {
+        // Hash collision. Rare enough to just hand back an uncached image
+        WARN("ROM hash collision for " + path);
+        return image;
+    }
+    byFile[fileKey] = image;
+    return image;
+}
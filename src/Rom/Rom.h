@@ -0,0 +1,56 @@
+#ifndef CHIP8_ROM_H
+#define CHIP8_ROM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// Read-only ROM contents. Shared by every machine that loads the same bytes
+class RomImage {
+public:
+    // Copies the bytes, so the image never changes with the file it came from
+    RomImage(const uint8_t *data, size_t size);
+
+    RomImage(const RomImage &) = delete;
+
+    RomImage &operator=(const RomImage &) = delete;
+
+    const uint8_t *Data() const { return bytes.data(); }
+
+    size_t Size() const { return bytes.size(); }
+
+    // FNV-1a of the contents
+    uint64_t Hash() const { return hash; }
+
+private:
+    std::vector<uint8_t> bytes;
+    uint64_t hash;
+};
+
+uint64_t HashRom(const uint8_t *data, size_t size);
+
+// Content-addressed cache, so repeated loads of the same ROM share one image
+class RomCache {
+public:
+    static RomCache &Global();
+
+    // Maps and validates the file, or returns the cached image with the same contents. Throws on failure
+    std::shared_ptr<const RomImage> Load(const std::string &path);
+
+private:
+    // Identifies an unchanged file, letting repeat loads skip mapping and hashing entirely
+    using FileKey = std::tuple<uint64_t, uint64_t, int64_t, int64_t, uint64_t>;
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const RomImage>> byHash;
+    std::map<FileKey, std::shared_ptr<const RomImage>> byFile;
+};
+
+
+#endif //CHIP8_ROM_H
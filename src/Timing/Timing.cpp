@@ -0,0 +1,202 @@
+#include "Timing.h"
+#include <stdexcept>
+#include "../Aot/AotModule.h"
+#include "../Debugger/Debugger.h"
+#include "../Logger/Logger.h"
+
+// The VIP clocks its 1802 at 1.76064 MHz and every machine cycle takes 8 clocks
+const unsigned int VIP_MACHINE_CYCLES_PER_FRAME = 1760640 / 8 / FRAMES_PER_SECOND;
+// Display DMA steals 8 cycles for each of the 128 scanlines, plus the interrupt routine itself
+const unsigned int VIP_DISPLAY_CYCLES = 128 * 8 + 44;
+// The interpreter's fetch and dispatch loop, about 20 1802 instructions of 2 machine cycles each
+const unsigned int VIP_DISPATCH_CYCLES = 40;
+// 00E0 zeroes all 256 display bytes, three 1802 instructions per byte
+const unsigned int VIP_CLEAR_CYCLES = 24 + 256 * 6;
+
+FixedTiming::FixedTiming(unsigned int ips) : ips{ips} {}
+
+unsigned int FixedTiming::CyclesPerFrame() const {
+    // Costing every instruction at FRAMES_PER_SECOND keeps fractional IPS / 60 rates exact
+    return ips;
+}
+
+unsigned int FixedTiming::Cost(const Chip8 &chip8, uint16_t opcode) const {
+    return FRAMES_PER_SECOND;
+}
+
+bool FixedTiming::WaitsForDisplay(uint16_t opcode) const {
+    return false;
+}
+
+unsigned int CosmacVipTiming::CyclesPerFrame() const {
+    return VIP_MACHINE_CYCLES_PER_FRAME - VIP_DISPLAY_CYCLES;
+}
+
+// Machine cycles spent in each instruction's routine, after dispatch. Derived from Laurence Scotford's
+// annotated disassembly of the VIP interpreter ("Chip-8 on the COSMAC VIP")
+static unsigned int VipExecuteCycles(const Chip8 &chip8, uint16_t opcode) {
+    uint8_t vx = chip8.registers[(opcode & 0x0F00u) >> 8];
+    uint8_t vy = chip8.registers[(opcode & 0x00F0u) >> 4];
+    // Skips spend a few more cycles incrementing the PC when taken
+    const unsigned int skip = 4;
+
+    switch ((opcode & 0xF000u) >> 12) {
+        case 0x0:
+            switch (opcode & 0x0FFFu) {
+                case 0x0E0:
+                    return VIP_CLEAR_CYCLES;
+                case 0x0EE:
+                    return 23;
+                default:
+                    // Machine code routine; nothing to run, but the dispatch still happens
+                    return 23;
+            }
+        case 0x1:
+        case 0x2:
+            return 23;
+        case 0x3:
+            return vx == (uint8_t) opcode ? 10 + skip : 10;
+        case 0x4:
+            return vx != (uint8_t) opcode ? 10 + skip : 10;
+        case 0x5:
+            return vx == vy ? 16 + skip : 16;
+        case 0x6:
+            return 6;
+        case 0x7:
+            return 10;
+        case 0x8:
+            return 44;
+        case 0x9:
+            return vx != vy ? 16 + skip : 16;
+        case 0xA:
+            return 12;
+        case 0xB:
+            return 23;
+        case 0xC:
+            return 36;
+        case 0xD: {
+            // Sprites not aligned to a byte are shifted across two display bytes, doubling the row cost
+            unsigned int rows = opcode & 0x000Fu;
+            unsigned int rowCost = (vx % 64) % 8 == 0 ? 17 : 34;
+            return 46 + rows * rowCost;
+        }
+        case 0xE:
+            switch (opcode & 0x00FFu) {
+                case 0x9E:
+                    return chip8.keypad[vx & 0x0Fu] ? 16 + skip : 16;
+                case 0xA1:
+                    return chip8.keypad[vx & 0x0Fu] ? 16 : 16 + skip;
+                default:
+                    return 16;
+            }
+        case 0xF:
+            switch (opcode & 0x00FFu) {
+                case 0x07:
+                case 0x0A:
+                case 0x15:
+                case 0x18:
+                    return 10;
+                case 0x1E:
+                    return 19;
+                case 0x29:
+                    return 20;
+                case 0x33:
+                    // Each digit is found by repeated subtraction
+                    return 84 + 8 * (vx / 100 + (vx / 10) % 10 + vx % 10);
+                case 0x55:
+                case 0x65:
+                    return 14 + 14 * (((opcode & 0x0F00u) >> 8) + 1);
+                default:
+                    return 10;
+            }
+        default:
+            return 10;
+    }
+}
+
+unsigned int CosmacVipTiming::Cost(const Chip8 &chip8, uint16_t opcode) const {
+    return VIP_DISPATCH_CYCLES + VipExecuteCycles(chip8, opcode);
+}
+
+bool CosmacVipTiming::WaitsForDisplay(uint16_t opcode) const {
+    // The VIP interpreter syncs sprite drawing with the display interrupt
+    return (opcode & 0xF000u) == 0xD000u;
+}
+
+std::unique_ptr<TimingModel> MakeTimingModel(const std::string &name, unsigned int ips) {
+    if (name == "fixed") {
+        return std::make_unique<FixedTiming>(ips);
+    }
+    if (name == "vip") {
+        return std::make_unique<CosmacVipTiming>();
+    }
+    ERROR("Unknown timing model: " + name);
+    throw std::invalid_argument("Unknown timing model: " + name);
+}
+
+Scheduler::Scheduler(const TimingModel &model) : model{model} {}
+
+unsigned int Scheduler::RunFrame(Chip8 &chip8) {
+    return RunFrameImpl<false, false>(chip8, nullptr, nullptr);
+}
+
+unsigned int Scheduler::RunFrame(Chip8 &chip8, Debugger &debugger, AotModule *module) {
+    return RunFrameImpl<true, false>(chip8, &debugger, module);
+}
+
+unsigned int Scheduler::RunFrame(Chip8 &chip8, AotModule &module) {
+    return RunFrameImpl<false, true>(chip8, nullptr, &module);
+}
+
+template<bool Debug, bool Compiled>
+unsigned int Scheduler::RunFrameImpl(Chip8 &chip8, Debugger *debugger, AotModule *module) {
+    unsigned int executed = 0;
+    cycleBalance += model.CyclesPerFrame();
+
+    while (cycleBalance > 0) {
+        if constexpr (Compiled) {
+            // Only when the whole block fits, so frame boundaries (and the timers) land where the interpreter puts them
+            const AotModule::Block *block = module->Lookup(chip8.pc);
+            if (block && cycleBalance >= block->cost) {
+                block->run(chip8);
+                cycleBalance -= block->cost;
+                totalCycles += block->cost;
+                executed += block->count;
+                continue;
+            }
+        }
+
+        if constexpr (Debug) {
+            if (!debugger->BeforeExecute(chip8))
+                return executed;
+        }
+
+        auto opcode = chip8.Fetch();
+        unsigned int cost = model.Cost(chip8, opcode);
+        if constexpr (Compiled) {
+            module->CheckWrite(chip8, opcode);
+        } else if constexpr (Debug) {
+            if (module)
+                module->CheckWrite(chip8, opcode);
+        }
+        chip8.Execute(opcode);
+
+        if constexpr (Debug) {
+            debugger->AfterExecute(chip8);
+        }
+
+        cycleBalance -= cost;
+        totalCycles += cost;
+        ++executed;
+
+        if (model.WaitsForDisplay(opcode)) {
+            // Whatever is left of this frame is spent waiting for vblank
+            if (cycleBalance > 0)
+                cycleBalance = 0;
+            break;
+        }
+    }
+
+    chip8.TickTimers();
+    return executed;
+}
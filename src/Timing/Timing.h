@@ -0,0 +1,85 @@
+#ifndef CHIP8_TIMING_H
+#define CHIP8_TIMING_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "../Chip8/Chip8.h"
+
+// Timers and the display both run at 60 Hz, so a frame is the scheduler's unit of work
+const unsigned int FRAMES_PER_SECOND = 60;
+
+class TimingModel {
+public:
+    virtual ~TimingModel() = default;
+
+    // Cycles available to the interpreter in one 60 Hz frame
+    virtual unsigned int CyclesPerFrame() const = 0;
+
+    // Cost of an opcode that has been fetched but not yet executed
+    virtual unsigned int Cost(const Chip8 &chip8, uint16_t opcode) const = 0;
+
+    // Whether the opcode stalls until the next vertical blank
+    virtual bool WaitsForDisplay(uint16_t opcode) const = 0;
+};
+
+// Every instruction costs the same, giving a fixed number of instructions per second
+class FixedTiming : public TimingModel {
+public:
+    explicit FixedTiming(unsigned int ips);
+
+    unsigned int CyclesPerFrame() const override;
+
+    unsigned int Cost(const Chip8 &chip8, uint16_t opcode) const override;
+
+    bool WaitsForDisplay(uint16_t opcode) const override;
+
+private:
+    unsigned int ips;
+};
+
+// Approximates the original COSMAC VIP interpreter, measured in 1802 machine cycles
+class CosmacVipTiming : public TimingModel {
+public:
+    unsigned int CyclesPerFrame() const override;
+
+    unsigned int Cost(const Chip8 &chip8, uint16_t opcode) const override;
+
+    bool WaitsForDisplay(uint16_t opcode) const override;
+};
+
+class Debugger;
+
+class AotModule;
+
+std::unique_ptr<TimingModel> MakeTimingModel(const std::string &name, unsigned int ips);
+
+class Scheduler {
+public:
+    explicit Scheduler(const TimingModel &model);
+
+    // Runs one frame worth of instructions, then ticks the timers. Returns instructions executed
+    unsigned int RunFrame(Chip8 &chip8);
+
+    // Same, with debugger hooks around every instruction. Writes are still checked against module, if given,
+    // so it isn't resumed with stale blocks once the debugger goes idle
+    unsigned int RunFrame(Chip8 &chip8, Debugger &debugger, AotModule *module = nullptr);
+
+    // Same, running compiled blocks from the module wherever one starts at pc
+    unsigned int RunFrame(Chip8 &chip8, AotModule &module);
+
+    uint64_t TotalCycles() const { return totalCycles; }
+
+private:
+    // Specialised at compile time so the fast loop carries no debugger or block lookup checks
+    template<bool Debug, bool Compiled>
+    unsigned int RunFrameImpl(Chip8 &chip8, Debugger *debugger, AotModule *module);
+
+    const TimingModel &model;
+    // Cycles left over (or owed) from the previous frame
+    int64_t cycleBalance{};
+    uint64_t totalCycles{};
+};
+
+
+#endif //CHIP8_TIMING_H
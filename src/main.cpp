@@ -1,57 +1,264 @@
 #include <sstream>
+#include "Aot/AotModule.h"
+#include "Audio/Audio.h"
 #include "Chip8/Chip8.h"
+#include "Debugger/Debugger.h"
 #include "Logger/Logger.h"
-#include "Platform/Platform.h"
+#include "Metrics/Metrics.h"
+#include "Platform/HeadlessPlatform.h"
+#include "Platform/SdlPlatform.h"
+#include "Platform/TerminalPlatform.h"
+#include "Rom/Rom.h"
+#include "Timing/Timing.h"
 #include "chrono"
+#include <climits>
+#include <cstring>
 
 const unsigned int WINDOW_WIDTH = 64;
 const unsigned int WINDOW_HEIGHT = 32;
-// Instructions per second
-const double IPS = 700;
-const double MS_PER_INSTRUCTION = 1000 / IPS;
+// Instructions per second for the fixed timing model
+const unsigned int IPS = 700;
+const double MS_PER_FRAME = 1000.0 / FRAMES_PER_SECOND;
+
+// Whole decimal numbers only; stoul alone would accept "10x" and wrap "-1"
+static unsigned long ParseNumber(const std::string &flag, const std::string &value, unsigned long max) {
+    if (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos) {
+        try {
+            unsigned long number = std::stoul(value);
+            if (number <= max)
+                return number;
+        } catch (std::out_of_range &) {}
+    }
+    ERROR("Invalid value for " + flag + ": " + value);
+    throw std::invalid_argument(flag + ": " + value);
+}
 
 int main(int argc, char **argv) {
     Logger::Init();
 
-    if (argc < 2) {
-        ERROR("Usage: chip8 ROM");
+    std::string timingName = "fixed";
+    std::string scalerName;
+    std::string paletteName = "mono";
+    std::string platformName = "sdl";
+    std::string cellName = "half";
+    std::string framesArg = "0";
+    bool debug = false;
+    std::string metricsPath;
+    std::string metricsPortArg = "0";
+    std::string audioName;
+    std::string wavPath = "chip8.wav";
+    std::string aotPath;
+    PresenterOptions presenterOptions;
+    std::string romPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--timing" && i + 1 < argc) {
+            timingName = argv[++i];
+        } else if (arg == "--scaler" && i + 1 < argc) {
+            scalerName = argv[++i];
+        } else if (arg == "--palette" && i + 1 < argc) {
+            paletteName = argv[++i];
+        } else if (arg == "--scanlines") {
+            presenterOptions.scanlines = true;
+        } else if (arg == "--platform" && i + 1 < argc) {
+            platformName = argv[++i];
+        } else if (arg == "--cells" && i + 1 < argc) {
+            cellName = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            framesArg = argv[++i];
+        } else if (arg == "--debug") {
+            debug = true;
+        } else if (arg == "--metrics-file" && i + 1 < argc) {
+            metricsPath = argv[++i];
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            metricsPortArg = argv[++i];
+        } else if (arg == "--audio" && i + 1 < argc) {
+            audioName = argv[++i];
+        } else if (arg == "--wav" && i + 1 < argc) {
+            wavPath = argv[++i];
+        } else if (arg == "--aot" && i + 1 < argc) {
+            aotPath = argv[++i];
+        } else {
+            romPath = arg;
+        }
+    }
+
+    if (romPath.empty()) {
+        ERROR("Usage: chip8 [--platform sdl|terminal|headless] [--timing fixed|vip] "
+              "[--scaler gpu|nearest|scale2x|scale3x] [--palette mono|amber|green|lcd] [--scanlines] "
+              "[--cells half|braille] [--frames N] [--debug] [--metrics-file PATH] [--metrics-port PORT] "
+              "[--audio sdl|null|wav] [--wav PATH] [--aot MODULE.so] ROM");
         exit(1);
     }
 
+    std::unique_ptr<TimingModel> timing;
     Chip8 chip8;
+    std::unique_ptr<AotModule> aot;
+    unsigned long maxFrames;
+    unsigned int metricsPort;
     try {
-        chip8.LoadROM(argv[1]);
+        maxFrames = ParseNumber("--frames", framesArg, ULONG_MAX);
+        metricsPort = ParseNumber("--metrics-port", metricsPortArg, 65535);
+        timing = MakeTimingModel(timingName, IPS);
+        // Scanlines are drawn on the CPU, so they need a CPU scaler; the GPU would stretch them into bands
+        if (scalerName.empty())
+            scalerName = presenterOptions.scanlines ? "nearest" : "gpu";
+        presenterOptions.scaler = ParseScaler(scalerName);
+        if (presenterOptions.scanlines && presenterOptions.scaler == Scaler::Gpu) {
+            ERROR("--scanlines needs a CPU scaler (nearest, scale2x or scale3x), not gpu");
+            throw std::invalid_argument("--scanlines with --scaler gpu");
+        }
+        presenterOptions.palette = ParsePalette(paletteName);
+        auto rom = RomCache::Global().Load(romPath);
+        chip8.LoadROM(*rom);
+        if (!aotPath.empty())
+            aot = std::make_unique<AotModule>(aotPath, rom->Hash(), *timing);
     } catch (std::exception &e) {
         ERROR(e.what());
         exit(1);
     }
     INFO("ROM loaded!");
 
-    Platform platform{"Chip8", WINDOW_WIDTH, WINDOW_HEIGHT,
-                      sizeof(chip8.display[0]) * WINDOW_WIDTH};
+    // Before the platform, so a failure here still exits with the terminal intact and the error visible
+    Metrics metrics;
+    std::unique_ptr<MetricsExporter> exporter;
+    if (!metricsPath.empty() || metricsPort) {
+        try {
+            exporter = std::make_unique<MetricsExporter>(metrics, metricsPath, metricsPort);
+        } catch (std::exception &e) {
+            ERROR(e.what());
+            exit(1);
+        }
+    }
+
+    // The debugger console shares stdin/stdout, so it can't run alongside the terminal renderer
+    std::unique_ptr<Debugger> debugger;
+    if (debug) {
+        if (platformName == "terminal") {
+            ERROR("--debug can't be used with the terminal platform");
+            exit(1);
+        }
+        // Created before SDL so Ctrl-C breaks into the debugger instead of quitting
+        debugger = std::make_unique<Debugger>(true);
+    }
+
+    // Also before the platform, for the same reason. Only the SDL platform has speakers to assume by default
+    if (audioName.empty())
+        audioName = platformName == "sdl" ? "sdl" : "null";
+    std::unique_ptr<AudioSink> audio;
+    try {
+        if (audioName == "sdl") {
+            audio = std::make_unique<SdlAudio>();
+        } else if (audioName == "wav") {
+            audio = std::make_unique<WavAudio>(wavPath);
+        } else if (audioName == "null") {
+            audio = std::make_unique<NullAudio>();
+        } else {
+            ERROR("Unknown audio output: " + audioName);
+            exit(1);
+        }
+    } catch (std::exception &e) {
+        ERROR(e.what());
+        exit(1);
+    }
+
+    std::unique_ptr<Platform> platform;
+    try {
+        if (platformName == "sdl") {
+            platform = std::make_unique<SdlPlatform>("Chip8", WINDOW_WIDTH, WINDOW_HEIGHT, presenterOptions);
+        } else if (platformName == "terminal") {
+            platform = std::make_unique<TerminalPlatform>(WINDOW_WIDTH, WINDOW_HEIGHT, ParseCellMode(cellName));
+        } else if (platformName == "headless") {
+            platform = std::make_unique<HeadlessPlatform>();
+        } else {
+            ERROR("Unknown platform: " + platformName);
+            exit(1);
+        }
+    } catch (std::exception &e) {
+        ERROR(e.what());
+        exit(1);
+    }
     INFO("Platform initialised!");
 
+    // Log lines would scribble over the terminal renderer's screen
+    auto logLevel = Logger::GetLogger()->level();
+    if (platformName == "terminal")
+        Logger::GetLogger()->set_level(spdlog::level::off);
+
+    Scheduler scheduler{*timing};
     bool isRunning = true;
+    unsigned long frames = 0;
     auto lastTime = std::chrono::high_resolution_clock::now();
-    INFO("Running...");
+    // Frames are due on a fixed 60 Hz grid, so a slow loop shows up as missed deadlines rather than drifting
+    const auto framePeriod = std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<double, std::milli>(MS_PER_FRAME));
+    auto nextFrame = lastTime + framePeriod;
+    // Set when the keypad changes, cleared once a frame reflecting it has been drawn
+    bool inputPending = false;
+    auto inputTime = lastTime;
+    INFO("Running with " + timingName + " timing...");
+
     while (isRunning) {
-        // for now, ignore keyboard input
-        isRunning = platform.HandleInput(chip8.keypad);
+        uint8_t keypad[sizeof(chip8.keypad)];
+        memcpy(keypad, chip8.keypad, sizeof(keypad));
+        isRunning = platform->HandleInput(chip8.keypad);
+        if (memcmp(keypad, chip8.keypad, sizeof(keypad)) != 0) {
+            metrics.keyEvents.Add();
+            if (!inputPending) {
+                inputPending = true;
+                inputTime = std::chrono::high_resolution_clock::now();
+            }
+        }
 
-        // wait for timer
+        // wait for the next 60 Hz frame
         auto now = std::chrono::high_resolution_clock::now();
-        double deltaTime = std::chrono::duration<double,
-                std::chrono::milliseconds::period>(now - lastTime).count();
-
-        if (deltaTime >= MS_PER_INSTRUCTION) {
-            // run Chip8
+        if (now >= nextFrame) {
+            // run one frame's cycle budget, then present it
+            metrics.frameInterval.Observe(std::chrono::duration<double>(now - lastTime).count());
             lastTime = now;
-            auto opcode = chip8.Fetch();
-            chip8.Execute(opcode);
-            platform.Draw(chip8.display);
+            // This frame covers the deadline that just passed; any others went by without a frame
+            nextFrame += framePeriod;
+            while (nextFrame <= now) {
+                metrics.missedFrames.Add();
+                nextFrame += framePeriod;
+            }
+
+            uint64_t cyclesBefore = scheduler.TotalCycles();
+            unsigned int executed;
+            // Only take the instrumented loop while the debugger has something to check
+            if (debugger && debugger->Active()) {
+                executed = scheduler.RunFrame(chip8, *debugger, aot.get());
+                if (debugger->QuitRequested())
+                    isRunning = false;
+            } else if (aot && aot->Valid()) {
+                executed = scheduler.RunFrame(chip8, *aot);
+            } else {
+                executed = scheduler.RunFrame(chip8);
+            }
+            audio->Publish(chip8.soundTimer > 0);
+            metrics.instructions.Add(executed);
+            metrics.cycles.Add(scheduler.TotalCycles() - cyclesBefore);
+            metrics.frames.Add();
+
+            auto drawStart = std::chrono::high_resolution_clock::now();
+            platform->Draw(chip8.display);
+            auto drawEnd = std::chrono::high_resolution_clock::now();
+            metrics.drawTime.Observe(std::chrono::duration<double>(drawEnd - drawStart).count());
+            if (inputPending) {
+                metrics.inputLatency.Observe(std::chrono::duration<double>(drawEnd - inputTime).count());
+                inputPending = false;
+            }
+
+            if (maxFrames && ++frames >= maxFrames)
+                isRunning = false;
         }
     }
-    INFO("Quitting...");
+    audio.reset();
+    platform.reset();
+    exporter.reset();
+    Logger::GetLogger()->set_level(logLevel);
+    INFO("Quitting after " + std::to_string(scheduler.TotalCycles()) + " cycles...");
+    INFO(metrics.Summary());
 
     return 0;
 }